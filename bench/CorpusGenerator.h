@@ -0,0 +1,177 @@
+#pragma once
+
+#include <string>
+#include <random>
+#include <sstream>
+
+using namespace std;
+
+
+/**
+ * Settings for the size and shape of a generated program.
+ */
+struct CorpusConfig
+{
+    /** amount of global functions (besides main) */
+    int functions = 100;
+    /** max nesting depth of if/while statements within a function body */
+    int statementDepth = 2;
+    /** probability [0, 1] of a comment before each statement */
+    double commentDensity = 0.2;
+    /** amount of classes, each with member variables and a member function */
+    int classes = 10;
+    unsigned seed = 42;
+};
+
+
+/**
+ * Generates syntactically and semantically valid malin programs for benchmarks.
+ * The same config always results in the same program.
+ */
+class CorpusGenerator
+{
+  public:
+    explicit CorpusGenerator(CorpusConfig config) : config(config), random(config.seed)
+    {}
+
+    string generate() {
+      out.str("");
+      out << "let globalCounter: i32 = 0;\n\n";
+      for (int i = 0; i < config.classes; ++i) {
+        genClass(i);
+      }
+      for (int i = 0; i < config.functions; ++i) {
+        genFunction(i);
+      }
+      genMain();
+      return out.str();
+    }
+
+  private:
+    CorpusConfig config;
+    mt19937 random;
+    stringstream out;
+
+    bool chance(double probability) {
+      return uniform_real_distribution<double>(0, 1)(random) < probability;
+    }
+
+    int randomInt(int min, int max) {
+      return uniform_int_distribution<int>(min, max)(random);
+    }
+
+    void indent(int depth) {
+      out << string(depth * 2, ' ');
+    }
+
+    void genComment(int depth) {
+      if (chance(config.commentDensity)) {
+        indent(depth);
+        if (chance(0.5)) {
+          out << "// compute the next value of the result\n";
+        } else {
+          out << "/* block comment\n";
+          indent(depth);
+          out << " * over multiple lines */\n";
+        }
+      }
+    }
+
+    void genClass(int index) {
+      genComment(0);
+      out << "class Point" << index << " {\n"
+          << "  x: i32 = " << randomInt(0, 9) << ";\n"
+          << "  y: i32 = " << randomInt(0, 9) << ";\n"
+          << "  fun sum(factor: i32): i32 {\n"
+          << "    return x * factor + y;\n"
+          << "  }\n"
+          << "}\n\n";
+    }
+
+    /**
+     * Integer expression using the parameters a and b and the local result.
+     */
+    string genExpression(int depth) {
+      int kind = randomInt(0, depth > 2 ? 2 : 4);
+      switch (kind) {
+        case 0:
+          return to_string(randomInt(0, 100));
+        case 1:
+          return chance(0.5) ? "a" : "result";
+        case 2:
+          return "b";
+        case 3:
+          return "(" + genExpression(depth + 1) + " + " + genExpression(depth + 1) + ")";
+        default:
+          return genExpression(depth + 1) + " * " + genExpression(depth + 1) + " - " + genExpression(depth + 1);
+      }
+    }
+
+    string genCondition() {
+      return genExpression(1) + " > " + genExpression(1) + " && result < 100000 || !(b == " + to_string(randomInt(0, 9)) + ")";
+    }
+
+    void genStatements(int depth, int maxDepth, int functionIndex) {
+      int statements = randomInt(2, 4);
+      for (int i = 0; i < statements; ++i) {
+        genComment(depth);
+        int kind = randomInt(0, depth < maxDepth ? 4 : 2);
+        indent(depth);
+        switch (kind) {
+          case 0:
+          case 1:
+            out << "result = result + " << genExpression(0) << ";\n";
+            break;
+          case 2:
+            if (functionIndex > 0) {
+              out << "result = result + fun" << randomInt(0, functionIndex - 1) << "(a, b = " << genExpression(1) << ");\n";
+            } else {
+              out << "result = result - a;\n";
+            }
+            break;
+          case 3:
+            out << "if " << genCondition() << " {\n";
+            genStatements(depth + 1, maxDepth, functionIndex);
+            indent(depth);
+            out << "} else {\n";
+            genStatements(depth + 1, maxDepth, functionIndex);
+            indent(depth);
+            out << "}\n";
+            break;
+          default:
+            out << "while result < " << randomInt(100, 10000) << " {\n";
+            genStatements(depth + 1, maxDepth, functionIndex);
+            indent(depth + 1);
+            out << "result = result + 1;\n";
+            indent(depth);
+            out << "}\n";
+            break;
+        }
+      }
+    }
+
+    void genFunction(int index) {
+      genComment(0);
+      out << "fun fun" << index << "(a: i32, b: i32 = 2): i32 {\n";
+      out << "  let result = a * " << randomInt(1, 9) << " + b;\n";
+      if (config.classes > 0) {
+        int classIndex = randomInt(0, config.classes - 1);
+        out << "  let point: Point" << classIndex << " = Point" << classIndex << "();\n";
+        out << "  point.x = a;\n";
+        out << "  result = result + point.sum(b);\n";
+      }
+      genStatements(1, config.statementDepth + 1, index);
+      out << "  return result;\n";
+      out << "}\n\n";
+    }
+
+    void genMain() {
+      out << "fun main(): i32 {\n";
+      out << "  let result = 0;\n";
+      if (config.functions > 0) {
+        out << "  result = fun" << config.functions - 1 << "(1);\n";
+      }
+      out << "  return result;\n";
+      out << "}\n";
+    }
+};
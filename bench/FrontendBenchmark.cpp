@@ -0,0 +1,170 @@
+#include <iostream>
+#include <experimental/filesystem>
+#include <lyra/lyra.hpp>
+#include <termcolor/termcolor.hpp>
+#include <benchmark/benchmark.h>
+#include <ir/builder/exceptions.h>
+#include "Log.h"
+#include "File.hpp"
+#include "lexer/Lexer.h"
+#include "parser/Parser.h"
+#include "SourceManager.h"
+#include "AstVisitor/AstCodePrinter.h"
+#include "decorator/AstDecorator.h"
+#include "ir/gen/IRGenerator.h"
+#include "parser/AST_addFunc.h"
+#include "CorpusGenerator.h"
+
+using namespace std;
+namespace fs = std::experimental::filesystem;
+
+
+/**
+ * Counts all nodes of an ast.
+ */
+static size_t countAstNodes(ASTNode *node) {
+  size_t count = 1;
+  auto children = node->getChildNodes();
+  auto end = children.end();
+  for (auto child = children.begin(); child != end; ++child) {
+    count += countAstNodes(*child);
+  }
+  return count;
+}
+
+/**
+ * Benchmark args: functions, statement depth, comment density in percent, classes
+ */
+static string generateCorpus(const benchmark::State &state) {
+  CorpusConfig config;
+  config.functions = state.range(0);
+  config.statementDepth = state.range(1);
+  config.commentDensity = state.range(2) / 100.0;
+  config.classes = state.range(3);
+  return CorpusGenerator(config).generate();
+}
+
+/**
+ * Locations of messages are resolved via the source manager.
+ */
+static void useAsSource(const string &source) {
+  fs::path path("generated.ma");
+  sourceManager.setSource(path, source);
+}
+
+/**
+ * Suppresses output to cout (e.g. messages of the parser and decorator) while it exists.
+ */
+class SilenceCout
+{
+  public:
+    SilenceCout() : coutBuffer(cout.rdbuf(nullptr))
+    {}
+
+    ~SilenceCout() {
+      cout.rdbuf(coutBuffer);
+    }
+
+  private:
+    streambuf *coutBuffer;
+};
+
+static void corpusArgs(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"functions", "depth", "comments%", "classes"});
+  benchmark->Args({100, 2, 20, 10});
+  benchmark->Args({1000, 2, 20, 100});
+  benchmark->Args({1000, 4, 20, 100});
+  benchmark->Args({1000, 2, 80, 100});
+  benchmark->Args({10000, 2, 20, 1000});
+  benchmark->Unit(benchmark::kMillisecond);
+}
+
+
+static void BM_Lexer(benchmark::State &state) {
+  string source = generateCorpus(state);
+  useAsSource(source);
+  size_t tokens = 0;
+  for (auto _ : state) {
+    Lexer lexer(source);
+    TokenBuffer buffer = lexer.getAllTokens();
+    tokens = buffer.size();
+    benchmark::DoNotOptimize(buffer);
+  }
+  state.SetBytesProcessed(state.iterations() * source.size());
+  state.counters["tokens/s"] = benchmark::Counter(tokens * state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Lexer)->Apply(corpusArgs);
+
+
+static void BM_Parser(benchmark::State &state) {
+  string source = generateCorpus(state);
+  useAsSource(source);
+  TokenBuffer tokens = Lexer(source).getAllTokens();
+  size_t nodes = 0;
+  SilenceCout silence;
+  for (auto _ : state) {
+    state.PauseTiming();
+    TokenBuffer tokensCopy = tokens;
+    state.ResumeTiming();
+
+    Parser parser(move(tokensCopy));
+    RootDeclarations root = parser.parse();
+
+    state.PauseTiming();
+    nodes = countAstNodes(&root);
+    // destruction of the ast is not measured
+    { RootDeclarations destroyed = move(root); }
+    state.ResumeTiming();
+  }
+  state.counters["nodes/s"] = benchmark::Counter(nodes * state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Parser)->Apply(corpusArgs);
+
+
+static void BM_LinkNames(benchmark::State &state) {
+  string source = generateCorpus(state);
+  useAsSource(source);
+  TokenBuffer tokens = Lexer(source).getAllTokens();
+  SilenceCout silence;
+  for (auto _ : state) {
+    state.PauseTiming();
+    RootDeclarations root = Parser(TokenBuffer(tokens)).parse();
+    state.ResumeTiming();
+
+    AstDecorator decorator;
+    bool ok = decorator.linkNames(root);
+    if (!ok) {
+      state.SkipWithError("decorating the generated program failed");
+      break;
+    }
+
+    state.PauseTiming();
+    { RootDeclarations destroyed = move(root); }
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_LinkNames)->Apply(corpusArgs);
+
+
+static void BM_ChildIteration(benchmark::State &state) {
+  string source = generateCorpus(state);
+  useAsSource(source);
+  RootDeclarations root = Parser(Lexer(source).getAllTokens()).parse();
+  {
+    SilenceCout silence;
+    if (!AstDecorator().linkNames(root)) {
+      state.SkipWithError("decorating the generated program failed");
+      return;
+    }
+  }
+  size_t nodes = 0;
+  for (auto _ : state) {
+    nodes = countAstNodes(&root);
+    benchmark::DoNotOptimize(nodes);
+  }
+  state.counters["nodes/s"] = benchmark::Counter(nodes * state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ChildIteration)->Apply(corpusArgs);
+
+
+BENCHMARK_MAIN();
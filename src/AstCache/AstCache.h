@@ -0,0 +1,120 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <experimental/filesystem>
+#include "File.hpp"
+#include "AstSerializer.h"
+
+using namespace std;
+namespace fs = std::experimental::filesystem;
+
+
+/**
+ * Caches decorated asts on disk, thus lexing, parsing and decorating can be skipped for unchanged source files.
+ * Each ast is stored in its own file named by the hash of its source text.
+ */
+class AstCache
+{
+  public:
+    explicit AstCache(fs::path directory = ".malinc-cache") : directory(move(directory))
+    {}
+
+    /**
+     * FNV-1a hash of the source text.
+     */
+    static uint64_t hashSource(string_view source) {
+      uint64_t hash = 14695981039346656037ull;
+      for (char c : source) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+      }
+      return hash;
+    }
+
+    /**
+     * Load the cached ast of the source into the given empty root.
+     * @return false if there is no valid cached ast for the source, root is empty then
+     */
+    bool load(string_view source, RootDeclarations &root) {
+      uint64_t hash = hashSource(source);
+      fs::path filePath = getFilePath(hash);
+      if (!fs::exists(filePath)) {
+        return false;
+      }
+
+      try {
+        MappedFile file(filePath);
+        AstDeserializer deserializer(file.getText());
+        if (deserializer.readHeader().sourceHash != hash) {
+          return false;
+        }
+        // read directly into root, thus the parent pointers of the global declarations point to it
+        deserializer.deserialize(root);
+        return true;
+      }
+      catch (runtime_error &e) {
+        // invalid or outdated cache files are replaced on the next save
+        root = RootDeclarations();
+        return false;
+      }
+    }
+
+    /**
+     * Store the decorated ast of the source.
+     * Asts with function bodies skipped by lazy parsing are not stored,
+     * a later compilation without lazy parsing has to parse and decorate these bodies.
+     * @return false if the ast was not stored since it has unparsed function bodies
+     * @throws runtime_error when the file can't be written
+     */
+    bool save(string_view source, RootDeclarations &root) {
+      if (hasUnparsedBodies(root)) {
+        return false;
+      }
+      uint64_t hash = hashSource(source);
+      vector<char> data = AstSerializer().serialize(root, hash);
+
+      fs::create_directories(directory);
+      fs::path filePath = getFilePath(hash);
+      // write to a temporary file first, thus other compiler processes never see a partially written file
+      fs::path tmpPath = filePath;
+      tmpPath += ".tmp" + to_string(getpid());
+      {
+        ofstream stream(tmpPath, ios::binary);
+        if (!stream) {
+          throw runtime_error("can't open file '" + tmpPath.string() + "'");
+        }
+        stream.write(data.data(), data.size());
+        if (!stream) {
+          throw runtime_error("can't write file '" + tmpPath.string() + "'");
+        }
+      }
+      fs::rename(tmpPath, filePath);
+      return true;
+    }
+
+    /**
+     * @return true if the body of a function was skipped by lazy parsing and is not parsed yet
+     */
+    static bool hasUnparsedBodies(RootDeclarations &root) {
+      // only global functions are parsed lazily
+      for (auto func : root.functionDeclarations) {
+        if (func->hasUnparsedBody()) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+  private:
+    fs::path directory;
+
+    fs::path getFilePath(uint64_t hash) {
+      stringstream name;
+      name << hex << setw(16) << setfill('0') << hash << ".mast";
+      return directory / name.str();
+    }
+};
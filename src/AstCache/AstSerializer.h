@@ -0,0 +1,775 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include "parser/AST.h"
+
+using namespace std;
+
+
+/**
+ * Binary format of a decorated ast:
+ *
+ *  AstFileHeader
+ *  nodes:   all nodes in pre-order, each node as kind (uint8), location and its fields.
+ *           Children are written inline, links to other nodes (e.g. VariableExpression::variableDeclaration)
+ *           and the class of ClassTypes are written as index of the linked node in pre-order.
+ *  strings: all names and string values, each as length (uint32) followed by its chars.
+ *
+ * Values are written in the native byte order, thus files are only valid on the machine that created them.
+ * Back end state like llvm values is not written.
+ */
+struct AstFileHeader {
+    static constexpr char MAGIC[4] = {'M', 'A', 'S', 'T'};
+    /** increase when the format or the ast nodes change */
+    static constexpr uint32_t FORMAT_VERSION = 2;
+
+    char magic[4];
+    uint32_t version;
+    /** hash of the source text the ast was created from */
+    uint64_t sourceHash;
+    uint32_t nodesCount;
+    uint32_t stringsCount;
+    /** offset of the strings section from the file start */
+    uint64_t stringsOffset;
+};
+
+/** marks a null child, link or type */
+static constexpr uint8_t AST_FILE_NULL_KIND = 0xFF;
+static constexpr uint32_t AST_FILE_NULL_INDEX = UINT32_MAX;
+
+
+/**
+ * Write a decorated ast into the binary format.
+ */
+class AstSerializer
+{
+  public:
+    /**
+     * @throws runtime_error when a function body was skipped by lazy parsing and is not parsed yet,
+     *         the tokens of the body are not written
+     */
+    vector<char> serialize(RootDeclarations &root, uint64_t sourceHash) {
+      out.clear();
+      out.resize(sizeof(AstFileHeader));
+
+      writeNode(&root);
+
+      // links can point to nodes written after the link
+      for (auto &[position, target] : links) {
+        auto found = nodeIndices.find(target);
+        uint32_t index = found != nodeIndices.end() ? found->second : AST_FILE_NULL_INDEX;
+        memcpy(out.data() + position, &index, sizeof(index));
+      }
+
+      AstFileHeader header{};
+      memcpy(header.magic, AstFileHeader::MAGIC, sizeof(header.magic));
+      header.version = AstFileHeader::FORMAT_VERSION;
+      header.sourceHash = sourceHash;
+      header.nodesCount = nodesCount;
+      header.stringsCount = strings.size();
+      header.stringsOffset = out.size();
+      memcpy(out.data(), &header, sizeof(header));
+
+      for (auto &str : strings) {
+        writeValue<uint32_t>(str.size());
+        out.insert(out.end(), str.begin(), str.end());
+      }
+      return move(out);
+    }
+
+  private:
+    vector<char> out;
+    uint32_t nodesCount = 0;
+    /** index of each written node, variable declarations are also found by their AbstractVariableDeclaration address */
+    unordered_map<const void*, uint32_t> nodeIndices;
+    /** position of a link in out and the node it links to */
+    vector<pair<size_t, const void*>> links;
+    vector<string> strings;
+    unordered_map<string, uint32_t> stringIndices;
+
+
+    template<class T>
+    void writeValue(T value) {
+      const char *bytes = reinterpret_cast<const char*>(&value);
+      out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    void writeString(const string &str) {
+      auto [it, inserted] = stringIndices.try_emplace(str, strings.size());
+      if (inserted) {
+        strings.push_back(str);
+      }
+      writeValue<uint32_t>(it->second);
+    }
+
+    void writeLink(const void *target) {
+      if (target) {
+        links.emplace_back(out.size(), target);
+      }
+      writeValue<uint32_t>(AST_FILE_NULL_INDEX);
+    }
+
+    void writeType(LangType *type) {
+      if (!type) {
+        writeValue<uint8_t>(AST_FILE_NULL_KIND);
+        return;
+      }
+      writeValue<uint8_t>(type->kind);
+      switch (type->kind) {
+        case LangType_Reference:
+          writeType(cast<ReferenceType>(type)->innerType);
+          break;
+        case LangType_Class:
+          writeLink(cast<ClassType>(type)->classDeclaration);
+          break;
+        case LangType_BuildIn:
+          writeValue<int8_t>(cast<BuildInType>(type)->type);
+          break;
+        default:
+          break;
+      }
+    }
+
+    void writeVariableDeclaration(AbstractVariableDeclaration *var) {
+      writeString(var->name.str());
+      writeString(var->typeName.str());
+      writeType(var->type);
+      writeValue<uint8_t>(var->isMutable);
+      writeLink(var->parentClass);
+      writeValue<int32_t>(var->memberIndex);
+      writeValue<uint8_t>(var->isThisOfClass);
+    }
+
+    template<class T>
+    void writeNodes(vector<T*> &nodes) {
+      writeValue<uint32_t>(nodes.size());
+      for (auto node : nodes) {
+        writeNode(node);
+      }
+    }
+
+    template<class T>
+    void writeValueNodes(vector<T> &nodes) {
+      writeValue<uint32_t>(nodes.size());
+      for (auto &node : nodes) {
+        writeNode(&node);
+      }
+    }
+
+    void writeNode(ASTNode *node) {
+      if (!node) {
+        writeValue<uint8_t>(AST_FILE_NULL_KIND);
+        return;
+      }
+      nodeIndices[node] = nodesCount;
+      if (auto var = AbstractVariableDeclaration::fromNode(node)) {
+        nodeIndices[var] = nodesCount;
+      }
+      nodesCount++;
+
+      writeValue<uint8_t>(node->kind);
+      writeValue<uint32_t>(node->location.offset);
+      writeValue<uint32_t>(node->location.length);
+      if (auto ex = dyn_cast<Expression>(node)) {
+        writeType(ex->resultType);
+      }
+
+      switch (node->kind) {
+        case Node_RootDeclarations: {
+          auto root = cast<RootDeclarations>(node);
+          writeNodes(root->classDeclarations);
+          writeNodes(root->variableDeclarations);
+          writeNodes(root->functionDeclarations);
+          writeLink(root->mainFunction);
+          break;
+        }
+        case Node_FunctionDeclaration: {
+          auto func = cast<FunctionDeclaration>(node);
+          if (func->hasUnparsedBody()) {
+            throw runtime_error("can't write function '" + func->name.str() + "', its body is not parsed");
+          }
+          writeString(func->name.str());
+          writeString(func->typeName.str());
+          writeValue<uint8_t>(func->isExtern);
+          writeType(func->returnType);
+          writeValueNodes(func->arguments);
+          writeNode(func->body);
+          writeLink(func->parentClass);
+          writeValue<uint8_t>(func->isConstructor);
+          break;
+        }
+        case Node_FunctionParamDeclaration: {
+          auto param = cast<FunctionParamDeclaration>(node);
+          writeVariableDeclaration(param);
+          writeNode(param->defaultExpression);
+          break;
+        }
+        case Node_ClassDeclaration: {
+          auto classDecl = cast<ClassDeclaration>(node);
+          writeString(classDecl->name.str());
+          writeNode(classDecl->constructor);
+          writeNode(classDecl->thisVarDecl);
+          writeNodes(classDecl->variableDeclarations);
+          writeNodes(classDecl->functionDeclarations);
+          break;
+        }
+        case Node_CallExpressionArgument: {
+          auto arg = cast<CallExpressionArgument>(node);
+          writeNode(arg->expression);
+          writeValue<uint8_t>(arg->argName.has_value());
+          if (arg->argName) {
+            writeString(arg->argName->str());
+          }
+          writeLink(arg->argumentDeclaration);
+          break;
+        }
+
+        // statements
+        case Node_VariableDeclaration: {
+          auto var = cast<VariableDeclaration>(node);
+          writeVariableDeclaration(var);
+          writeNode(var->initExpression);
+          break;
+        }
+        case Node_ReturnStatement: {
+          auto ret = cast<ReturnStatement>(node);
+          writeNode(ret->expression);
+          writeType(ret->returnType);
+          break;
+        }
+        case Node_CompoundStatement:
+          writeNodes(cast<CompoundStatement>(node)->statements);
+          break;
+        case Node_IfStatement: {
+          auto ifSt = cast<IfStatement>(node);
+          writeNode(ifSt->condition);
+          writeNode(ifSt->ifBody);
+          writeNode(ifSt->elseBody);
+          break;
+        }
+        case Node_WhileStatement: {
+          auto whileSt = cast<WhileStatement>(node);
+          writeNode(whileSt->condition);
+          writeNode(whileSt->body);
+          break;
+        }
+        case Node_VariableAssignStatement: {
+          auto assign = cast<VariableAssignStatement>(node);
+          writeNode(assign->variableExpression);
+          writeNode(assign->valueExpression);
+          break;
+        }
+
+        // expressions
+        case Node_UnaryExpression: {
+          auto unary = cast<UnaryExpression>(node);
+          writeValue<int8_t>(unary->operation);
+          writeNode(unary->innerExpression);
+          break;
+        }
+        case Node_BinaryExpression: {
+          auto binary = cast<BinaryExpression>(node);
+          writeValue<int8_t>(binary->operation);
+          writeNode(binary->lhs);
+          writeNode(binary->rhs);
+          break;
+        }
+        case Node_VariableExpression:
+        case Node_MemberVariableExpression: {
+          auto variable = cast<VariableExpression>(node);
+          writeString(variable->name.str());
+          writeLink(variable->variableDeclaration);
+          if (auto member = dyn_cast<MemberVariableExpression>(node)) {
+            writeNode(member->parent);
+          }
+          break;
+        }
+        case Node_CallExpression:
+        case Node_MemberCallExpression: {
+          auto call = cast<CallExpression>(node);
+          writeString(call->calledName.str());
+          writeLink(call->functionDeclaration);
+          if (auto member = dyn_cast<MemberCallExpression>(node)) {
+            writeNode(member->parent);
+          }
+          writeValueNodes(call->argumentsNonNamed);
+          writeValueNodes(call->argumentsNamed);
+          break;
+        }
+        case Node_NumberIntExpression:
+          writeValue<int32_t>(cast<NumberIntExpression>(node)->value);
+          break;
+        case Node_NumberFloatExpression:
+          writeValue<float>(cast<NumberFloatExpression>(node)->value);
+          break;
+        case Node_StringExpression:
+          writeString(cast<StringExpression>(node)->value);
+          break;
+        case Node_BoolExpression:
+          writeValue<uint8_t>(cast<BoolExpression>(node)->value);
+          break;
+      }
+    }
+};
+
+
+/**
+ * Read an ast written by AstSerializer.
+ * Nodes are created in the arena of the root, parents and self pointers are set like the parser does.
+ * All strings are copied, thus the data (e.g. a memory mapped file) is not needed after reading.
+ */
+class AstDeserializer
+{
+  public:
+    explicit AstDeserializer(string_view data) : data(data)
+    {}
+
+    /**
+     * @return the header of the data
+     * @throws runtime_error when the data is no ast file of the current format version
+     */
+    AstFileHeader readHeader() {
+      AstFileHeader header{};
+      if (data.size() < sizeof(header)) {
+        throw runtime_error("ast file is too small");
+      }
+      memcpy(&header, data.data(), sizeof(header));
+      if (memcmp(header.magic, AstFileHeader::MAGIC, sizeof(header.magic)) != 0) {
+        throw runtime_error("ast file has no valid header");
+      }
+      if (header.version != AstFileHeader::FORMAT_VERSION) {
+        throw runtime_error("ast file has format version " + to_string(header.version)
+                            + " but version " + to_string(AstFileHeader::FORMAT_VERSION) + " is required");
+      }
+      return header;
+    }
+
+    /**
+     * Read the whole ast into the given empty root.
+     * @throws runtime_error when the data is invalid
+     */
+    void deserialize(RootDeclarations &root) {
+      AstFileHeader header = readHeader();
+      arena = root.arena.get();
+      types = root.types.get();
+
+      // strings
+      position = header.stringsOffset;
+      symbols.reserve(header.stringsCount);
+      for (uint32_t i = 0; i < header.stringsCount; i++) {
+        uint32_t length = readValue<uint32_t>();
+        checkAvailable(length);
+        symbols.emplace_back(data.substr(position, length));
+        position += length;
+      }
+
+      // nodes
+      position = sizeof(AstFileHeader);
+      nodes.reserve(header.nodesCount);
+      if (readKind() != Node_RootDeclarations) {
+        throw runtime_error("ast file does not start with the root node");
+      }
+      readNodeInto(&root);
+      if (nodes.size() != header.nodesCount) {
+        throw runtime_error("ast file has " + to_string(nodes.size()) + " nodes but " + to_string(header.nodesCount) + " were expected");
+      }
+
+      for (auto &link : links) {
+        if (link.index >= nodes.size()) {
+          throw runtime_error("ast file contains link to invalid node");
+        }
+        link.assign(link.field, nodes[link.index]);
+      }
+      for (auto &link : classTypeLinks) {
+        auto classDecl = link.index < nodes.size() ? dyn_cast<ClassDeclaration>(nodes[link.index]) : nullptr;
+        if (!classDecl) {
+          throw runtime_error("ast file contains class type with invalid class");
+        }
+        LangType *type = types->getClassType(classDecl);
+        for (uint32_t i = 0; i < link.referenceDepth; i++) {
+          type = types->getReferenceType(type);
+        }
+        *link.field = type;
+      }
+
+      // parents of global declarations are linked like the parser does
+      for (auto decl : root.classDeclarations) {
+        decl->parentAstNode = &root;
+      }
+      for (auto decl : root.variableDeclarations) {
+        decl->parentAstNode = &root;
+      }
+      for (auto decl : root.functionDeclarations) {
+        decl->parentAstNode = &root;
+      }
+    }
+
+  private:
+    /** link field to assign after all nodes are read */
+    struct Link {
+        void *field;
+        uint32_t index;
+        void (*assign)(void *field, ASTNode *node);
+    };
+
+    /** type field to assign after all nodes are read, the class type can be wrapped in references */
+    struct ClassTypeLink {
+        LangType **field;
+        uint32_t index;
+        uint32_t referenceDepth;
+    };
+
+    string_view data;
+    size_t position = 0;
+    AstArena *arena = nullptr;
+    TypeContext *types = nullptr;
+    vector<Symbol> symbols;
+    vector<ASTNode*> nodes;
+    vector<Link> links;
+    vector<ClassTypeLink> classTypeLinks;
+
+
+    void checkAvailable(size_t bytes) {
+      if (position + bytes > data.size()) {
+        throw runtime_error("ast file is truncated");
+      }
+    }
+
+    template<class T>
+    T readValue() {
+      checkAvailable(sizeof(T));
+      T value;
+      memcpy(&value, data.data() + position, sizeof(T));
+      position += sizeof(T);
+      return value;
+    }
+
+    const Symbol &readSymbol() {
+      uint32_t index = readValue<uint32_t>();
+      if (index >= symbols.size()) {
+        throw runtime_error("ast file contains invalid string index");
+      }
+      return symbols[index];
+    }
+
+    uint8_t readKind() {
+      return readValue<uint8_t>();
+    }
+
+    /**
+     * The linked node as T, nullptr if it has an other type.
+     */
+    template<class T>
+    static void assignLink(void *field, ASTNode *node) {
+      if constexpr (is_same<T, AbstractVariableDeclaration>::value) {
+        *static_cast<T**>(field) = AbstractVariableDeclaration::fromNode(node);
+      }
+      else {
+        *static_cast<T**>(field) = dyn_cast<T>(node);
+      }
+    }
+
+    template<class T>
+    void readLink(T *&field) {
+      uint32_t index = readValue<uint32_t>();
+      field = nullptr;
+      if (index != AST_FILE_NULL_INDEX) {
+        links.push_back(Link{&field, index, &assignLink<T>});
+      }
+    }
+
+    /**
+     * Read a type into the field, class types are assigned after all nodes are read.
+     */
+    void readType(LangType *&field) {
+      uint32_t referenceDepth = 0;
+      uint8_t kind = readKind();
+      for (; kind == LangType_Reference; kind = readKind()) {
+        referenceDepth++;
+      }
+
+      LangType *type;
+      switch (kind) {
+        case AST_FILE_NULL_KIND:
+          type = nullptr;
+          break;
+        case LangType_Invalid:
+          type = types->getInvalidType();
+          break;
+        case LangType_BuildIn: {
+          int8_t buildIn = readValue<int8_t>();
+          if (buildIn < 0 || buildIn >= BuildIn_Count) {
+            throw runtime_error("ast file contains invalid build in type " + to_string(buildIn));
+          }
+          type = types->getBuildInType(static_cast<BUILD_IN_TYPE>(buildIn));
+          break;
+        }
+        case LangType_Class:
+          classTypeLinks.push_back(ClassTypeLink{&field, readValue<uint32_t>(), referenceDepth});
+          field = nullptr;
+          return;
+        default:
+          throw runtime_error("ast file contains invalid type kind " + to_string(kind));
+      }
+      if (!type && referenceDepth > 0) {
+        throw runtime_error("ast file contains reference to null type");
+      }
+      for (uint32_t i = 0; i < referenceDepth; i++) {
+        type = types->getReferenceType(type);
+      }
+      field = type;
+    }
+
+    void readVariableDeclaration(AbstractVariableDeclaration *var) {
+      var->name = readSymbol();
+      var->typeName = readSymbol();
+      readType(var->type);
+      var->isMutable = readValue<uint8_t>();
+      readLink(var->parentClass);
+      var->memberIndex = readValue<int32_t>();
+      var->isThisOfClass = readValue<uint8_t>();
+    }
+
+    ASTNode *makeNode(uint8_t kind) {
+      switch (kind) {
+        case Node_FunctionDeclaration: return arena->make<FunctionDeclaration>();
+        case Node_ClassDeclaration: return arena->make<ClassDeclaration>();
+        case Node_VariableDeclaration: return arena->make<VariableDeclaration>();
+        case Node_ReturnStatement: return arena->make<ReturnStatement>();
+        case Node_CompoundStatement: return arena->make<CompoundStatement>();
+        case Node_IfStatement: return arena->make<IfStatement>();
+        case Node_WhileStatement: return arena->make<WhileStatement>();
+        case Node_VariableAssignStatement: return arena->make<VariableAssignStatement>();
+        case Node_UnaryExpression: return arena->make<UnaryExpression>();
+        case Node_BinaryExpression: return arena->make<BinaryExpression>();
+        case Node_VariableExpression: return arena->make<VariableExpression>();
+        case Node_MemberVariableExpression: return arena->make<MemberVariableExpression>();
+        case Node_CallExpression: return arena->make<CallExpression>();
+        case Node_MemberCallExpression: return arena->make<MemberCallExpression>();
+        case Node_NumberIntExpression: return arena->make<NumberIntExpression>();
+        case Node_NumberFloatExpression: return arena->make<NumberFloatExpression>();
+        case Node_StringExpression: return arena->make<StringExpression>();
+        case Node_BoolExpression: return arena->make<BoolExpression>();
+        default:
+          throw runtime_error("ast file contains invalid node kind " + to_string(kind));
+      }
+    }
+
+    /**
+     * Read a child node that is linked by a pointer.
+     * @return nullptr for a null child
+     * @throws runtime_error when the node is not of type T
+     */
+    template<class T>
+    T *readNode() {
+      uint8_t kind = readKind();
+      if (kind == AST_FILE_NULL_KIND) {
+        return nullptr;
+      }
+      auto node = dyn_cast<T>(makeNode(kind));
+      if (!node) {
+        throw runtime_error("ast file contains node of kind " + to_string(kind) + " at an unexpected position");
+      }
+      readNodeInto(node);
+      return node;
+    }
+
+    template<class T>
+    void readNodes(vector<T*> &nodes, ASTNode *parent) {
+      nodes.resize(readValue<uint32_t>());
+      for (auto &node : nodes) {
+        node = readNode<T>();
+        if (!node) {
+          throw runtime_error("ast file contains null node in list");
+        }
+        linkChild(parent, node);
+      }
+    }
+
+    /**
+     * Read nodes that are stored by value.
+     * The vector is resized before reading, thus the addresses of the nodes stay valid.
+     */
+    template<class T>
+    void readValueNodes(vector<T> &nodes, ASTNode *parent) {
+      nodes.resize(readValue<uint32_t>());
+      for (auto &node : nodes) {
+        if (readKind() != node.kind) {
+          throw runtime_error("ast file contains node of kind at an unexpected position");
+        }
+        readNodeInto(&node);
+        linkChild(parent, &node);
+      }
+    }
+
+    /**
+     * Read the fields of a node, its kind has already been read.
+     */
+    void readNodeInto(ASTNode *node) {
+      nodes.push_back(node);
+      node->location.offset = readValue<uint32_t>();
+      node->location.length = readValue<uint32_t>();
+      if (auto ex = dyn_cast<Expression>(node)) {
+        readType(ex->resultType);
+      }
+
+      switch (node->kind) {
+        case Node_RootDeclarations: {
+          auto root = cast<RootDeclarations>(node);
+          readNodes(root->classDeclarations, root);
+          readNodes(root->variableDeclarations, root);
+          readNodes(root->functionDeclarations, root);
+          readLink(root->mainFunction);
+          break;
+        }
+        case Node_FunctionDeclaration: {
+          auto func = cast<FunctionDeclaration>(node);
+          func->name = readSymbol();
+          func->typeName = readSymbol();
+          func->isExtern = readValue<uint8_t>();
+          readType(func->returnType);
+          readValueNodes(func->arguments, func);
+          func->body = readNode<CompoundStatement>();
+          linkChild(func, func->body);
+          readLink(func->parentClass);
+          func->isConstructor = readValue<uint8_t>();
+          break;
+        }
+        case Node_FunctionParamDeclaration: {
+          auto param = cast<FunctionParamDeclaration>(node);
+          readVariableDeclaration(param);
+          param->defaultExpression = readNode<Expression>();
+          linkChild(param, param->defaultExpression);
+          break;
+        }
+        case Node_ClassDeclaration: {
+          auto classDecl = cast<ClassDeclaration>(node);
+          classDecl->name = readSymbol();
+          classDecl->constructor = readNode<FunctionDeclaration>();
+          linkChild(classDecl, classDecl->constructor);
+          classDecl->thisVarDecl = readNode<VariableDeclaration>();
+          linkChild(classDecl, classDecl->thisVarDecl);
+          readNodes(classDecl->variableDeclarations, classDecl);
+          readNodes(classDecl->functionDeclarations, classDecl);
+          break;
+        }
+        case Node_CallExpressionArgument: {
+          auto arg = cast<CallExpressionArgument>(node);
+          arg->expression = readNode<Expression>();
+          linkChild(arg, arg->expression);
+          if (readValue<uint8_t>()) {
+            arg->argName = readSymbol();
+          }
+          readLink(arg->argumentDeclaration);
+          break;
+        }
+
+        // statements
+        case Node_VariableDeclaration: {
+          auto var = cast<VariableDeclaration>(node);
+          readVariableDeclaration(var);
+          var->initExpression = readNode<Expression>();
+          linkChild(var, var->initExpression);
+          break;
+        }
+        case Node_ReturnStatement: {
+          auto ret = cast<ReturnStatement>(node);
+          ret->expression = readNode<Expression>();
+          linkChild(ret, ret->expression);
+          readType(ret->returnType);
+          break;
+        }
+        case Node_CompoundStatement: {
+          auto comp = cast<CompoundStatement>(node);
+          readNodes(comp->statements, comp);
+          break;
+        }
+        case Node_IfStatement: {
+          auto ifSt = cast<IfStatement>(node);
+          ifSt->condition = readNode<Expression>();
+          ifSt->ifBody = readNode<CompoundStatement>();
+          ifSt->elseBody = readNode<CompoundStatement>();
+          linkChild(ifSt, ifSt->condition);
+          linkChild(ifSt, ifSt->ifBody);
+          linkChild(ifSt, ifSt->elseBody);
+          break;
+        }
+        case Node_WhileStatement: {
+          auto whileSt = cast<WhileStatement>(node);
+          whileSt->condition = readNode<Expression>();
+          whileSt->body = readNode<CompoundStatement>();
+          linkChild(whileSt, whileSt->condition);
+          linkChild(whileSt, whileSt->body);
+          break;
+        }
+        case Node_VariableAssignStatement: {
+          auto assign = cast<VariableAssignStatement>(node);
+          assign->variableExpression = readNode<VariableExpression>();
+          assign->valueExpression = readNode<Expression>();
+          linkChild(assign, assign->variableExpression);
+          linkChild(assign, assign->valueExpression);
+          break;
+        }
+
+        // expressions
+        case Node_UnaryExpression: {
+          auto unary = cast<UnaryExpression>(node);
+          unary->operation = static_cast<UnaryExpressionOp>(readValue<int8_t>());
+          unary->innerExpression = readNode<Expression>();
+          linkChild(unary, unary->innerExpression);
+          break;
+        }
+        case Node_BinaryExpression: {
+          auto binary = cast<BinaryExpression>(node);
+          binary->operation = static_cast<BinaryExpressionOp>(readValue<int8_t>());
+          binary->lhs = readNode<Expression>();
+          binary->rhs = readNode<Expression>();
+          linkChild(binary, binary->lhs);
+          linkChild(binary, binary->rhs);
+          break;
+        }
+        case Node_VariableExpression:
+        case Node_MemberVariableExpression: {
+          auto variable = cast<VariableExpression>(node);
+          variable->name = readSymbol();
+          readLink(variable->variableDeclaration);
+          if (auto member = dyn_cast<MemberVariableExpression>(node)) {
+            member->parent = readNode<Expression>();
+            linkChild(member, member->parent);
+          }
+          break;
+        }
+        case Node_CallExpression:
+        case Node_MemberCallExpression: {
+          auto call = cast<CallExpression>(node);
+          call->calledName = readSymbol();
+          readLink(call->functionDeclaration);
+          if (auto member = dyn_cast<MemberCallExpression>(node)) {
+            member->parent = readNode<Expression>();
+            linkChild(member, member->parent);
+          }
+          readValueNodes(call->argumentsNonNamed, call);
+          readValueNodes(call->argumentsNamed, call);
+          break;
+        }
+        case Node_NumberIntExpression:
+          cast<NumberIntExpression>(node)->value = readValue<int32_t>();
+          break;
+        case Node_NumberFloatExpression:
+          cast<NumberFloatExpression>(node)->value = readValue<float>();
+          break;
+        case Node_StringExpression:
+          cast<StringExpression>(node)->value = readSymbol().str();
+          break;
+        case Node_BoolExpression:
+          cast<BoolExpression>(node)->value = readValue<uint8_t>();
+          break;
+      }
+    }
+};
@@ -40,17 +40,17 @@ class AstCodePrinter: AstVisitor<void, int>
 
     void visitRootDecl(RootDeclarations *rootDecl, int depth) override {
       for (auto &decl: rootDecl->classDeclarations) {
-        accept(decl.get(), 0);
+        accept(decl, 0);
         os << endl << endl << endl;
       }
       for (auto &decl: rootDecl->variableDeclarations) {
-        accept(decl.get(), 0);
+        accept(decl, 0);
         osInd();
         os << ";";
       }
       os << endl << endl;
-      for (auto &decl: rootDecl->functionDeclarations) {
-        accept(&decl, 0);
+      for (auto decl: rootDecl->functionDeclarations) {
+        accept(decl, 0);
         os << endl << endl;
       }
     }
@@ -63,7 +63,7 @@ class AstCodePrinter: AstVisitor<void, int>
       os << ": " << varDecl->type->toString();
       if (varDecl->initExpression) {
         os << " = ";
-        accept(varDecl->initExpression.get(), 0);
+        accept(varDecl->initExpression, 0);
       }
     }
 
@@ -84,7 +84,7 @@ class AstCodePrinter: AstVisitor<void, int>
         i++;
       }
       os << "): " << funcDecl->returnType->toString() << " ";
-      accept(funcDecl->body.get(), depth);
+      accept(funcDecl->body, depth);
     }
 
     void visitFunctionParamDeclaration(FunctionParamDeclaration *funcParam, int depth) override {
@@ -92,7 +92,7 @@ class AstCodePrinter: AstVisitor<void, int>
       os << ": " << funcParam->type->toString();
       if (funcParam->defaultExpression) {
         os << " = ";
-        accept(funcParam->defaultExpression.get(), depth);
+        accept(funcParam->defaultExpression, depth);
       }
     }
 
@@ -101,13 +101,13 @@ class AstCodePrinter: AstVisitor<void, int>
       os <<" {" << endl;
       for (auto &e : classDecl->variableDeclarations) {
         osInd(depth+1);
-        accept(e.get(), depth+1);
+        accept(e, depth+1);
         os << ";" << endl;
       }
-      for (auto &e : classDecl->functionDeclarations) {
+      for (auto e : classDecl->functionDeclarations) {
         os << endl;
         osInd(depth+1);
-        accept(&e, depth+1);
+        accept(e, depth+1);
         os << endl;
       }
       os <<"}";
@@ -122,7 +122,7 @@ class AstCodePrinter: AstVisitor<void, int>
       os << "{" << endl;
       for (auto &child : st->statements) {
         osInd(depth+1);
-        accept(child.get(), depth+1);
+        accept(child, depth+1);
         os << ";" << endl;
       }
       osInd(depth);
@@ -130,37 +130,37 @@ class AstCodePrinter: AstVisitor<void, int>
     }
 
     void visitVariableAssignStatement(VariableAssignStatement *st, int depth) override {
-      accept(st->variableExpression.get(), depth);
+      accept(st->variableExpression, depth);
       os << " = ";
-      accept(st->valueExpression.get(), depth);
+      accept(st->valueExpression, depth);
     }
 
     void visitReturnStatement(ReturnStatement *st, int depth) override {
       os << "return";
       if (st->expression) {
         os << " ";
-        accept(st->expression->get(), depth);
+        accept(st->expression, depth);
       }
     }
 
     void visitIfStatement(IfStatement *st, int depth) override {
       os << "if (";
-      accept(st->condition.get(), depth);
+      accept(st->condition, depth);
       os << ") ";
-      accept(st->ifBody.get(), depth);
+      accept(st->ifBody, depth);
       if (st->elseBody) {
         os << endl;
         osInd(depth);
         os << "else ";
-        accept(st->elseBody.get(), depth);
+        accept(st->elseBody, depth);
       }
     }
 
     void visitWhileStatement(WhileStatement *st, int depth) override {
       os << "while (";
-      accept(st->condition.get(), depth);
+      accept(st->condition, depth);
       os << ")";
-      accept(st->body.get(), depth);
+      accept(st->body, depth);
     }
 
 
@@ -186,7 +186,7 @@ class AstCodePrinter: AstVisitor<void, int>
     }
 
     void visitMemberVariableExpression(MemberVariableExpression *ex, int depth) override {
-      accept(ex->parent.get(), depth);
+      accept(ex->parent, depth);
       os << "." << ex->variableDeclaration->name;
     }
 
@@ -206,28 +206,28 @@ class AstCodePrinter: AstVisitor<void, int>
     }
 
     void visitMemberCallExpression(MemberCallExpression *ex, int depth) override {
-      accept(ex->parent.get(), depth);
+      accept(ex->parent, depth);
       os << ".";
       visitCallExpression(ex, depth);
     }
 
     void visitCallExpressionArgument(CallExpressionArgument *ex, int depth) override {
       os << ex->argumentDeclaration->name << "=";
-      accept(ex->expression.get(), depth);
+      accept(ex->expression, depth);
     }
 
 
     void visitUnaryExpression(UnaryExpression *ex, int depth) override {
       os << "(" << toString(ex->operation);
-      accept(ex->innerExpression.get(), depth);
+      accept(ex->innerExpression, depth);
       os << ")";
     }
 
     void visitBinaryExpression(BinaryExpression *ex, int depth) override {
       os << "(";
-      accept(ex->lhs.get(), depth);
+      accept(ex->lhs, depth);
       os << " " << toString(ex->operation) << " ";
-      accept(ex->rhs.get(), depth);
+      accept(ex->rhs, depth);
       os << ")";
     }
 
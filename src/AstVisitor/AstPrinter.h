@@ -60,7 +60,7 @@ class AstPrinter: AstVisitor<void, int>
       accept(node, parentDepth+2);
     }
 
-    void printType(unique_ptr<LangType> &type, int parentDepth) {
+    void printType(LangType *type, int parentDepth) {
       if (type)
         printAttribute("type", type->toString(), parentDepth);
     }
@@ -73,10 +73,10 @@ class AstPrinter: AstVisitor<void, int>
     void beforeEachVisit(ASTNode *node, int depth) override {
       nextLine(depth);
       os << termcolor::underline;
-      if (dynamic_cast<Expression*>(node)) {
+      if (isa<Expression>(node)) {
         os << termcolor::yellow << node->nodeName() << termcolor::reset;
       }
-      else if (dynamic_cast<Statement*>(node)) {
+      else if (isa<Statement>(node)) {
         os << termcolor::green << node->nodeName() << termcolor::reset;
       }
       else {
@@ -91,15 +91,15 @@ class AstPrinter: AstVisitor<void, int>
     void visitRootDecl(RootDeclarations *rootDecl, int depth) override {
       printAttribute("classes", depth);
       for (auto &decl: rootDecl->classDeclarations) {
-        printSubNode(decl.get(), depth);
+        printSubNode(decl, depth);
       }
       printAttribute("globalVariables", depth);
       for (auto &decl: rootDecl->variableDeclarations) {
-        printSubNode(decl.get(), depth);
+        printSubNode(decl, depth);
       }
       printAttribute("functions", depth);
-      for (auto &decl: rootDecl->functionDeclarations) {
-        printSubNode(&decl, depth);
+      for (auto decl: rootDecl->functionDeclarations) {
+        printSubNode(decl, depth);
       }
       os << endl;
     }
@@ -117,7 +117,7 @@ class AstPrinter: AstVisitor<void, int>
 
       if (varDecl->initExpression) {
         printAttribute("init", depth);
-        printSubNode(varDecl->initExpression.get(), depth);
+        printSubNode(varDecl->initExpression, depth);
       }
     }
 
@@ -135,7 +135,7 @@ class AstPrinter: AstVisitor<void, int>
       }
       if (funcDecl->body) {
         printAttribute("body", depth);
-        printSubNode(funcDecl->body.get(), depth);
+        printSubNode(funcDecl->body, depth);
       }
     }
 
@@ -149,7 +149,7 @@ class AstPrinter: AstVisitor<void, int>
 
       if (funcParam->defaultExpression) {
         printAttribute("defaultExpression", depth);
-        printSubNode(funcParam->defaultExpression.get(), depth);
+        printSubNode(funcParam->defaultExpression, depth);
       }
     }
 
@@ -158,11 +158,11 @@ class AstPrinter: AstVisitor<void, int>
       printLocation(classDecl);
       printAttribute("memberVariables", depth);
       for (auto &e : classDecl->variableDeclarations) {
-        printSubNode(e.get(), depth);
+        printSubNode(e, depth);
       }
       printAttribute("memberFunctions", depth);
-      for (auto &e : classDecl->functionDeclarations) {
-        printSubNode(&e, depth);
+      for (auto e : classDecl->functionDeclarations) {
+        printSubNode(e, depth);
       }
     }
 
@@ -175,16 +175,16 @@ class AstPrinter: AstVisitor<void, int>
       printLocation(st);
       printAttribute("statements", depth);
       for (auto &child : st->statements) {
-        printSubNode(child.get(), depth);
+        printSubNode(child, depth);
       }
     }
 
     void visitVariableAssignStatement(VariableAssignStatement *st, int depth) override {
       printLocation(st);
       printAttribute("variable", depth);
-      printSubNode(st->variableExpression.get(), depth);
+      printSubNode(st->variableExpression, depth);
       printAttribute("value", depth);
-      printSubNode(st->valueExpression.get(), depth);
+      printSubNode(st->valueExpression, depth);
     }
 
     void visitReturnStatement(ReturnStatement *st, int depth) override {
@@ -195,28 +195,28 @@ class AstPrinter: AstVisitor<void, int>
       }
       if (st->expression) {
         printAttribute("expression", depth);
-        printSubNode(st->expression->get(), depth);
+        printSubNode(st->expression, depth);
       }
     }
 
     void visitIfStatement(IfStatement *st, int depth) override {
       printLocation(st);
       printAttribute("condition", depth);
-      printSubNode(st->condition.get(), depth);
+      printSubNode(st->condition, depth);
       printAttribute("ifBody", depth);
-      printSubNode(st->ifBody.get(), depth);
+      printSubNode(st->ifBody, depth);
       if (st->elseBody) {
         printAttribute("elseBody", depth);
-        printSubNode(st->elseBody.get(), depth);
+        printSubNode(st->elseBody, depth);
       }
     }
 
     void visitWhileStatement(WhileStatement *st, int depth) override {
       printLocation(st);
       printAttribute("condition", depth);
-      printSubNode(st->condition.get(), depth);
+      printSubNode(st->condition, depth);
       printAttribute("body", depth);
-      printSubNode(st->body.get(), depth);
+      printSubNode(st->body, depth);
     }
 
 
@@ -260,7 +260,7 @@ class AstPrinter: AstVisitor<void, int>
       os << ")";
       printType(ex->resultType, depth);
       printAttribute("parentExpr", depth);
-      printSubNode(ex->parent.get(), depth);
+      printSubNode(ex->parent, depth);
     }
 
 
@@ -269,7 +269,7 @@ class AstPrinter: AstVisitor<void, int>
       printLocation(ex);
       printType(ex->resultType, depth);
       if (ex->functionDeclaration) {
-        printAttribute("functionDeclarationName", ex->functionDeclaration->name, depth);
+        printAttribute("functionDeclarationName", ex->functionDeclaration->name.str(), depth);
       }
       if (!ex->argumentsNonNamed.empty()) {
         printAttribute("arguments", depth);
@@ -286,7 +286,7 @@ class AstPrinter: AstVisitor<void, int>
     void visitMemberCallExpression(MemberCallExpression *ex, int depth) override {
       visitCallExpression(ex, depth);
       printAttribute("parentExpr:", depth);
-      printSubNode(ex->parent.get(), depth);
+      printSubNode(ex->parent, depth);
     }
 
     void visitCallExpressionArgument(CallExpressionArgument *ex, int depth) override {
@@ -298,9 +298,9 @@ class AstPrinter: AstVisitor<void, int>
         os << "UNNAMED";
       os << ")";
       if (ex->argumentDeclaration) {
-        printAttribute("argumentDeclarationName", ex->argumentDeclaration->name, depth);
+        printAttribute("argumentDeclarationName", ex->argumentDeclaration->name.str(), depth);
       }
-      printSubNode(ex->expression.get(), depth);
+      printSubNode(ex->expression, depth);
     }
 
 
@@ -308,16 +308,16 @@ class AstPrinter: AstVisitor<void, int>
       os << "(operation: " << termcolor::bold << toString(ex->operation) << termcolor::reset << ")";
       printType(ex->resultType, depth);
       printAttribute("innerExpr", depth);
-      printSubNode(ex->innerExpression.get(), depth);
+      printSubNode(ex->innerExpression, depth);
     }
 
     void visitBinaryExpression(BinaryExpression *ex, int depth) override {
       os << "(operation: " << termcolor::bold << toString(ex->operation) << termcolor::reset << ")";
       printType(ex->resultType, depth);
       printAttribute("lhs", depth);
-      printSubNode(ex->lhs.get(), depth);
+      printSubNode(ex->lhs, depth);
       printAttribute("rhs", depth);
-      printSubNode(ex->rhs.get(), depth);
+      printSubNode(ex->rhs, depth);
     }
 
 
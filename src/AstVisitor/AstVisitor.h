@@ -61,80 +61,62 @@ class AstVisitor
 
 
     RESULT accept(ASTNode *node, ARG arg = nullptr) {
-      if (node) {
-        beforeEachVisit(node, arg);
-      }
-
-      // Declarations
-      if (auto n = dynamic_cast<RootDeclarations*>(node)) {
-        return visitRootDecl(n, arg);
-      }
-      else if (auto n = dynamic_cast<VariableDeclaration*>(node)) {
-        return visitVariableDecl(n, arg);
-      }
-      else if (auto n = dynamic_cast<FunctionDeclaration*>(node)) {
-        return visitFunctionDecl(n, arg);
-      }
-      else if (auto n = dynamic_cast<FunctionParamDeclaration*>(node)) {
-        return visitFunctionParamDeclaration(n, arg);
-      }
-      else if (auto n = dynamic_cast<ClassDeclaration*>(node)) {
-        return visitClassDecl(n, arg);
-      }
-
-      // Statements
-      else if (auto n = dynamic_cast<CompoundStatement*>(node)) {
-        return visitCompoundStatement(n, arg);
-      }
-      else if (auto n = dynamic_cast<VariableAssignStatement*>(node)) {
-        return visitVariableAssignStatement(n, arg);
-      }
-      else if (auto n = dynamic_cast<ReturnStatement*>(node)) {
-        return visitReturnStatement(n, arg);
-      }
-      else if (auto n = dynamic_cast<IfStatement*>(node)) {
-        return visitIfStatement(n, arg);
-      }
-      else if (auto n = dynamic_cast<WhileStatement*>(node)) {
-        return visitWhileStatement(n, arg);
-      }
-
-      // Expressions
-      else if (auto n = dynamic_cast<BoolExpression*>(node)) {
-        return visitBoolExpression(n, arg);
-      }
-      else if (auto n = dynamic_cast<NumberIntExpression*>(node)) {
-        return visitNumberIntExpression(n, arg);
-      }
-      else if (auto n = dynamic_cast<NumberFloatExpression*>(node)) {
-        return visitNumberFloatExpression(n, arg);
-      }
-      else if (auto n = dynamic_cast<StringExpression*>(node)) {
-        return visitStringExpression(n, arg);
-      }
-
-      else if (auto n = dynamic_cast<MemberVariableExpression*>(node)) {
-        return visitMemberVariableExpression(n, arg);
-      }
-      else if (auto n = dynamic_cast<VariableExpression*>(node)) {
-        return visitVariableExpression(n, arg);
-      }
-
-      else if (auto n = dynamic_cast<MemberCallExpression*>(node)) {
-        return visitMemberCallExpression(n, arg);
-      }
-      else if (auto n = dynamic_cast<CallExpression*>(node)) {
-        return visitCallExpression(n, arg);
-      }
-      else if (auto n = dynamic_cast<CallExpressionArgument*>(node)) {
-        return visitCallExpressionArgument(n, arg);
-      }
-
-      else if (auto n = dynamic_cast<UnaryExpression*>(node)) {
-        return visitUnaryExpression(n, arg);
-      }
-      else if (auto n = dynamic_cast<BinaryExpression*>(node)) {
-        return visitBinaryExpression(n, arg);
+      if (!node) {
+        return visitUnknownNode(node, arg);
+      }
+      beforeEachVisit(node, arg);
+
+      switch (node->kind) {
+        // Declarations
+        case Node_RootDeclarations:
+          return visitRootDecl(static_cast<RootDeclarations*>(node), arg);
+        case Node_VariableDeclaration:
+          return visitVariableDecl(static_cast<VariableDeclaration*>(node), arg);
+        case Node_FunctionDeclaration:
+          return visitFunctionDecl(static_cast<FunctionDeclaration*>(node), arg);
+        case Node_FunctionParamDeclaration:
+          return visitFunctionParamDeclaration(static_cast<FunctionParamDeclaration*>(node), arg);
+        case Node_ClassDeclaration:
+          return visitClassDecl(static_cast<ClassDeclaration*>(node), arg);
+
+        // Statements
+        case Node_CompoundStatement:
+          return visitCompoundStatement(static_cast<CompoundStatement*>(node), arg);
+        case Node_VariableAssignStatement:
+          return visitVariableAssignStatement(static_cast<VariableAssignStatement*>(node), arg);
+        case Node_ReturnStatement:
+          return visitReturnStatement(static_cast<ReturnStatement*>(node), arg);
+        case Node_IfStatement:
+          return visitIfStatement(static_cast<IfStatement*>(node), arg);
+        case Node_WhileStatement:
+          return visitWhileStatement(static_cast<WhileStatement*>(node), arg);
+
+        // Expressions
+        case Node_BoolExpression:
+          return visitBoolExpression(static_cast<BoolExpression*>(node), arg);
+        case Node_NumberIntExpression:
+          return visitNumberIntExpression(static_cast<NumberIntExpression*>(node), arg);
+        case Node_NumberFloatExpression:
+          return visitNumberFloatExpression(static_cast<NumberFloatExpression*>(node), arg);
+        case Node_StringExpression:
+          return visitStringExpression(static_cast<StringExpression*>(node), arg);
+
+        case Node_MemberVariableExpression:
+          return visitMemberVariableExpression(static_cast<MemberVariableExpression*>(node), arg);
+        case Node_VariableExpression:
+          return visitVariableExpression(static_cast<VariableExpression*>(node), arg);
+
+        case Node_MemberCallExpression:
+          return visitMemberCallExpression(static_cast<MemberCallExpression*>(node), arg);
+        case Node_CallExpression:
+          return visitCallExpression(static_cast<CallExpression*>(node), arg);
+        case Node_CallExpressionArgument:
+          return visitCallExpressionArgument(static_cast<CallExpressionArgument*>(node), arg);
+
+        case Node_UnaryExpression:
+          return visitUnaryExpression(static_cast<UnaryExpression*>(node), arg);
+        case Node_BinaryExpression:
+          return visitBinaryExpression(static_cast<BinaryExpression*>(node), arg);
       }
 
       return visitUnknownNode(node, arg);
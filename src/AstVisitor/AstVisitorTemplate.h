@@ -22,19 +22,19 @@ class AstVisitorTemplate: public AstVisitor<RESULT, A>
 
     void visitRootDecl(RootDeclarations *rootDecl, A arg) override {
       for (auto &decl: rootDecl->classDeclarations) {
-        accept(decl.get(), arg);
+        accept(decl, arg);
       }
       for (auto &decl: rootDecl->variableDeclarations) {
-        accept(decl.get(), arg);
+        accept(decl, arg);
       }
-      for (auto &decl: rootDecl->functionDeclarations) {
-        accept(&decl, arg);
+      for (auto decl: rootDecl->functionDeclarations) {
+        accept(decl, arg);
       }
     }
 
     void visitVariableDecl(VariableDeclaration *varDecl, A arg) override {
       if (varDecl->initExpression) {
-        accept(varDecl->initExpression.get(), arg);
+        accept(varDecl->initExpression, arg);
       }
     }
 
@@ -42,21 +42,21 @@ class AstVisitorTemplate: public AstVisitor<RESULT, A>
       for (auto &a : funcDecl->arguments) {
         accept(&a, arg);
       }
-      accept(funcDecl->body.get(), arg);
+      accept(funcDecl->body, arg);
     }
 
     void visitFunctionParamDeclaration(FunctionParamDeclaration *funcParam, A arg) override {
       if (funcParam->defaultExpression) {
-        accept(funcParam->defaultExpression.get(), arg);
+        accept(funcParam->defaultExpression, arg);
       }
     }
 
     void visitClassDecl(ClassDeclaration *classDecl, A arg) override {
       for (auto &e : classDecl->variableDeclarations) {
-        accept(e.get(), arg);
+        accept(e, arg);
       }
-      for (auto &e : classDecl->functionDeclarations) {
-        accept(&e, arg);
+      for (auto e : classDecl->functionDeclarations) {
+        accept(e, arg);
       }
     }
 
@@ -67,32 +67,32 @@ class AstVisitorTemplate: public AstVisitor<RESULT, A>
 
     void visitCompoundStatement(CompoundStatement *st, A arg) override {
       for (auto &child : st->statements) {
-        accept(child.get(), arg);
+        accept(child, arg);
       }
     }
 
     void visitVariableAssignStatement(VariableAssignStatement *st, A arg) override {
-      accept(st->variableExpression.get(), arg);
-      accept(st->valueExpression.get(), arg);
+      accept(st->variableExpression, arg);
+      accept(st->valueExpression, arg);
     }
 
     void visitReturnStatement(ReturnStatement *st, A arg) override {
       if (st->expression) {
-        accept(st->expression->get(), arg);
+        accept(st->expression, arg);
       }
     }
 
     void visitIfStatement(IfStatement *st, A arg) override {
-      accept(st->condition.get(), arg);
-      accept(st->ifBody.get(), arg);
+      accept(st->condition, arg);
+      accept(st->ifBody, arg);
       if (st->elseBody) {
-        accept(st->elseBody.get(), arg);
+        accept(st->elseBody, arg);
       }
     }
 
     void visitWhileStatement(WhileStatement *st, A arg) override {
-      accept(st->condition.get(), arg);
-      accept(st->body.get(), arg);
+      accept(st->condition, arg);
+      accept(st->body, arg);
     }
 
 
@@ -114,7 +114,7 @@ class AstVisitorTemplate: public AstVisitor<RESULT, A>
     }
 
     void visitMemberVariableExpression(MemberVariableExpression *ex, A arg) override {
-      accept(ex->parent.get(), arg);
+      accept(ex->parent, arg);
     }
 
 
@@ -125,22 +125,22 @@ class AstVisitorTemplate: public AstVisitor<RESULT, A>
     }
 
     void visitMemberCallExpression(MemberCallExpression *ex, A arg) override {
-      accept(ex->parent.get(), arg);
+      accept(ex->parent, arg);
       visitCallExpression(ex, arg);
     }
 
     void visitCallExpressionArgument(CallExpressionArgument *ex, A arg) override {
-      accept(ex->expression.get(), arg);
+      accept(ex->expression, arg);
     }
 
 
     void visitUnaryExpression(UnaryExpression *ex, A arg) override {
-      accept(ex->innerExpression.get(), arg);
+      accept(ex->innerExpression, arg);
     }
 
     void visitBinaryExpression(BinaryExpression *ex, A arg) override {
-      accept(ex->lhs.get(), arg);
-      accept(ex->rhs.get(), arg);
+      accept(ex->lhs, arg);
+      accept(ex->rhs, arg);
     }
 };
 
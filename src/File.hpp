@@ -3,6 +3,11 @@
 #include<iostream>
 #include <experimental/filesystem>
 #include <fstream>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace std;
 namespace fs = std::experimental::filesystem;
@@ -36,3 +41,77 @@ class File
 };
 
 
+/*
+ * Read only memory mapping of a whole file.
+ * The mapped text stays valid until the MappedFile is destroyed or moved from.
+ */
+class MappedFile
+{
+  public:
+    MappedFile() = default;
+
+    /**
+     * Map the file at filePath into memory.
+     * @throws runtime_error when the file can't be opened or mapped
+     */
+    explicit MappedFile(const fs::path &filePath) {
+      int fd = open(filePath.c_str(), O_RDONLY);
+      if (fd < 0) {
+        throw runtime_error("can't open file '" + filePath.string() + "'");
+      }
+      struct stat fileStat{};
+      if (fstat(fd, &fileStat) != 0) {
+        close(fd);
+        throw runtime_error("can't get size of file '" + filePath.string() + "'");
+      }
+      size = fileStat.st_size;
+
+      // an empty file can't be mapped
+      if (size > 0) {
+        void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+          close(fd);
+          throw runtime_error("can't map file '" + filePath.string() + "' into memory");
+        }
+        data = static_cast<const char*>(mapped);
+      }
+      close(fd);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept {
+      *this = move(other);
+    }
+
+    MappedFile &operator=(MappedFile &&other) noexcept {
+      if (this != &other) {
+        unmap();
+        data = other.data;
+        size = other.size;
+        other.data = nullptr;
+        other.size = 0;
+      }
+      return *this;
+    }
+
+    ~MappedFile() {
+      unmap();
+    }
+
+    string_view getText() const {
+      return string_view(data, size);
+    }
+
+  private:
+    const char *data = nullptr;
+    size_t size = 0;
+
+    void unmap() {
+      if (data) {
+        munmap((void*) data, size);
+        data = nullptr;
+      }
+    }
+};
@@ -7,6 +7,7 @@
 
 
 #include <iostream>
+#include <unistd.h>
 #include <termcolor/termcolor.hpp>
 #include <utility>
 #include "lexer/Lexer.h"
@@ -17,6 +18,11 @@ using namespace std;
 namespace fs = std::experimental::filesystem;
 namespace tc = termcolor;
 
+/**
+ * Stream that messages with source location are printed to, per thread.
+ */
+static thread_local ostream *messagesStream = &cout;
+
 class MsgScope;
 static MsgScope printMessage(
     const string& title,
@@ -73,24 +79,26 @@ static MsgScope printMessage(
     std::ostream& (*formatter)(std::ostream& stream),
     MsgScope *previousMsg)
 {
-  string srcLine = sourceManager.getLine(location.start.line);
+  SrcLocation start = location.getStart();
+  string_view srcLine = sourceManager.getLine(start.line);
 
   // create src location marker
   string srcLocationIndentation;
-  for (int i = 0; i < location.start.column - 1; ++i) {
+  for (int i = 0; i < start.column - 1; ++i) {
     srcLocationIndentation += " ";
   }
   string srcLocationMarker = srcLocationIndentation + "^";
   bool endAtOtherLine = false;
-  if (location.end) {
+  SrcLocation end = location.getEnd();
+  if (location.length > 0) {
     int columnEnd;
-    if (location.start.line == location.end->line) {
-      columnEnd = location.end->column;
+    if (start.line == end.line) {
+      columnEnd = end.column;
     } else {
       columnEnd = (int)srcLine.size() + 1;
       endAtOtherLine = true;
     }
-    for (int i = location.start.column+1; i < columnEnd; ++i) {
+    for (int i = start.column+1; i < columnEnd; ++i) {
       srcLocationMarker += "^";
     }
   }
@@ -98,22 +106,23 @@ static MsgScope printMessage(
   // append text to marker
   string textAfterMarker;
   if (endAtOtherLine) {
-    int linesDiff = location.end->line - location.start.line;
+    int linesDiff = end.line - start.line;
     srcLocationMarker += " °°° ";
     textAfterMarker = "and next " + to_string(linesDiff) + " lines ";
-    textAfterMarker += "until " + location.end->toString();
+    textAfterMarker += "until " + end.toString();
   }
 
   // print all
+  ostream &out = *messagesStream;
   if (!previousMsg) {
-    cout << endl;
+    out << endl;
   }
-  cout << sourceManager.getFilePathString() << ":" << location.start.toString() << ": "
-       << tc::bold << formatter << title << tc::reset << endl
-       << " | " /* << location.toString() */ << endl
-       << " | " << srcLine << endl
-       << " | " << formatter << srcLocationMarker << tc::grey << textAfterMarker << tc::reset << endl
-       << " | " << formatter << srcLocationIndentation << msg << tc::reset << endl;
+  out << sourceManager.getFilePathString() << ":" << start.toString() << ": "
+      << tc::bold << formatter << title << tc::reset << endl
+      << " | " /* << location.toString() */ << endl
+      << " | " << srcLine << endl
+      << " | " << formatter << srcLocationMarker << tc::grey << textAfterMarker << tc::reset << endl
+      << " | " << formatter << srcLocationIndentation << msg << tc::reset << endl;
 
   return MsgScope(location);
 }
@@ -157,4 +166,31 @@ static MsgScope printNote(
       msg,
       location,
       tc::white);
-}
\ No newline at end of file
+}
+
+
+/**
+ * Print the messages with source location of the current thread into the given stream while this exists,
+ * e.g. to collect the messages of work done in parallel and print them in order afterwards.
+ */
+class MessagesRedirect {
+  public:
+    explicit MessagesRedirect(ostream &stream) : previousStream(messagesStream)
+    {
+      // keep the colors when the collected messages are printed to the terminal later
+      if (isatty(STDOUT_FILENO)) {
+        stream << tc::colorize;
+      }
+      messagesStream = &stream;
+    }
+
+    MessagesRedirect(const MessagesRedirect &) = delete;
+    MessagesRedirect &operator=(const MessagesRedirect &) = delete;
+
+    ~MessagesRedirect() {
+      messagesStream = previousStream;
+    }
+
+  private:
+    ostream *previousStream;
+};
@@ -4,35 +4,132 @@
 #include <fstream>
 #include <termcolor/termcolor.hpp>
 #include <lyra/lyra.hpp>
+#include <algorithm>
+#include <cstdint>
+#include "File.hpp"
+#include "lexer/CharScan.h"
 
 using namespace std;
 using namespace lyra;
 namespace fs = std::experimental::filesystem;
 
 
+/**
+ * Line and column of a char in the source text, both start at 1.
+ */
+class SrcLocation
+{
+  public:
+    int line;
+    int column;
+
+    SrcLocation(int line, int column)
+        : line(line), column(column)
+    {
+    }
+
+    string toString() const
+    {
+      return "" + to_string(line) + ":" + to_string(column);
+    }
+};
+
+
+/**
+ * Maps the offsets stored in locations to offsets in the source text,
+ * e.g. for an ast whose locations are not moved when the text before them is edited.
+ */
+class SourceOffsetMap {
+  public:
+    virtual ~SourceOffsetMap() = default;
+
+    virtual uint32_t toSourceOffset(uint32_t offset) const = 0;
+};
+
+
 class SourceManager {
   public:
-    void setSource(fs::path &filePath, string &srcFile) {
-      this->filePath = filePath;
+    /**
+     * Memory-map the source file and use it as source.
+     * The returned text is owned by the SourceManager and stays valid as long as the SourceManager exists,
+     * thus tokens and ast nodes can reference it without copying.
+     * @throws runtime_error when the file can't be read
+     */
+    string_view loadSource(fs::path &filePath) {
+      sourceFile = MappedFile(filePath);
+      setSource(filePath, sourceFile.getText());
+      return sourceFile.getText();
+    }
 
-      // split lines
-      // @todo ignore '\r'
-      auto ss = std::stringstream(srcFile);
-      for (std::string line; std::getline(ss, line);) {
-        lines.push_back(line);
-      }
+    /**
+     * Use the given text as source.
+     */
+    void setSource(fs::path &filePath, string_view srcFile) {
+      this->filePath = filePath;
+      this->source = srcFile;
+      lineStarts.clear();
     }
 
     /**
      * first line is 1
+     * @return view into the source without the line break, empty if the line does not exist
      */
-    string getLine(int index) {
-      if (index - 1 < lines.size()) {
-        return lines[index - 1];
+    string_view getLine(int index) {
+      if (lineStarts.empty()) {
+        buildLineStarts();
       }
-      else {
+      if (index < 1 || index > lineStarts.size()) {
         return "";
       }
+
+      size_t lineStart = lineStarts[index - 1];
+      size_t lineEnd = index < lineStarts.size() ? lineStarts[index] - 1 : source.size();
+      if (lineEnd > lineStart && source[lineEnd - 1] == '\r') {
+        lineEnd--;
+      }
+      return source.substr(lineStart, lineEnd - lineStart);
+    }
+
+    /**
+     * Get line and column of a char offset in the source text.
+     * The line start table is build on the first call.
+     * @param offset byte offset into the source or offset mapped by the offset map, UINT32_MAX (invalid location) gives -1:-1
+     */
+    SrcLocation getSrcLocation(uint32_t offset) {
+      if (offset == UINT32_MAX) {
+        return SrcLocation(-1, -1);
+      }
+      if (offsetMap) {
+        offset = offsetMap->toSourceOffset(offset);
+      }
+      if (lineStarts.empty()) {
+        buildLineStarts();
+      }
+      // last line start that is <= offset
+      auto lineStart = upper_bound(lineStarts.begin(), lineStarts.end(), offset) - 1;
+      return SrcLocation(lineStart - lineStarts.begin() + 1, offset - *lineStart + 1);
+    }
+
+    /**
+     * Build the line start table now if not done yet,
+     * afterwards lines and locations can be requested from multiple threads at once.
+     */
+    void prepareLineStarts() {
+      if (lineStarts.empty()) {
+        buildLineStarts();
+      }
+    }
+
+    /**
+     * Map the offsets of locations before resolving them, nullptr to use them as they are.
+     * The map has to stay valid until it is replaced.
+     */
+    void setOffsetMap(const SourceOffsetMap *map) {
+      offsetMap = map;
+    }
+
+    const SourceOffsetMap *getOffsetMap() const {
+      return offsetMap;
     }
 
     string getFilePathString() {
@@ -40,9 +137,20 @@ class SourceManager {
     }
 
   private:
-    vector<string> lines;
+    MappedFile sourceFile;
+    string_view source;
+    /** offsets of the first char of each line, build lazily when a location or line is requested */
+    vector<uint32_t> lineStarts;
+    const SourceOffsetMap *offsetMap = nullptr;
     fs::path filePath;
 
+    void buildLineStarts() {
+      lineStarts.push_back(0);
+      const char *text = source.data();
+      for (size_t i = charScan::find(text, 0, source.size(), '\n'); i < source.size(); i = charScan::find(text, i + 1, source.size(), '\n')) {
+        lineStarts.push_back(i + 1);
+      }
+    }
 };
 
 static SourceManager sourceManager;
\ No newline at end of file
@@ -25,6 +25,7 @@
 #include <utility>
 #include "BinOperationTypes.h"
 #include "exceptions.h"
+#include "../decorator/ReachableDeclarations.h"
 
 using namespace std;
 using namespace llvm;
@@ -46,45 +47,59 @@ class CodeGenerator {
     }
 
 
+    /**
+     * Generate code of the functions and classes that are reachable from the main function.
+     */
     void generateCode(RootDeclarations &root) {
+      reachable = ReachableDeclarations(root);
       genTypes();
 
       // gen globals
       for (auto &global : root.variableDeclarations) {
-        genGlobal(global.get());
+        genGlobal(global);
       }
 
       // gen function declarations (no body)
-      for (auto &function : root.functionDeclarations) {
-        genFunctionDeclaration(&function);
+      for (auto function : root.functionDeclarations) {
+        // lazy parsed function is not reachable from main
+        if (function->hasUnparsedBody() || !reachable.contains(function)) {
+          continue;
+        }
+        genFunctionDeclaration(function);
       }
 
 
+      // only reachable classes
+      vector<ClassDeclaration*> classDeclarations;
+      copy_if(root.classDeclarations.begin(), root.classDeclarations.end(), back_inserter(classDeclarations), [&](ClassDeclaration *classDecl) {
+        return reachable.contains(classDecl);
+      });
+
       // gen class types
-      for (auto &classDecl : root.classDeclarations) {
+      for (auto &classDecl : classDeclarations) {
         classDecl->llvmStructType = llvm::StructType::create(context);
         classDecl->llvmStructType ->setName("class_" + classDecl->name);
       }
       // assign class types members
-      for (auto &classDecl : root.classDeclarations) {
-        genClassDeclTypeMembers(classDecl.get());
+      for (auto &classDecl : classDeclarations) {
+        genClassDeclTypeMembers(classDecl);
       }
       // save class sizes
-      for (auto &classDecl : root.classDeclarations) {
+      for (auto &classDecl : classDeclarations) {
         classDecl->llvmStructSizeBytes = dataLayout.getTypeAllocSize(classDecl->llvmStructType);
         cout << "-- class '"<< classDecl->name <<"' size: " << classDecl->llvmStructSizeBytes << " bytes" << endl;
       }
 
 
       // gen function bodies
-      for (auto &function : root.functionDeclarations) {
-        if (!function.isExtern) {
-          genFunctionBody(&function);
+      for (auto function : root.functionDeclarations) {
+        if (!function->isExtern && !function->hasUnparsedBody() && reachable.contains(function)) {
+          genFunctionBody(function);
         }
       }
       // class function bodies
-      for (auto &classDecl : root.classDeclarations) {
-        genClassDeclMemberFunctions(classDecl.get());
+      for (auto &classDecl : classDeclarations) {
+        genClassDeclMemberFunctions(classDecl);
       }
 
 
@@ -137,8 +152,9 @@ class CodeGenerator {
 
   private:
     void genGlobal(VariableDeclaration *var) {
-      auto* ex = dynamic_cast<NumberExpression*>(var->initExpression.get());
-      if (!ex) {
+      // the decorator folds constant init expressions into a single value
+      auto* ex = dyn_cast_or_null<ConstValueExpression>(var->initExpression);
+      if (!ex || isa<StringExpression>(ex)) {
         printError("", "globals need to have a constant init expression -> global ignored", var->location);
         return;
       }
@@ -146,7 +162,7 @@ class CodeGenerator {
       auto constant = dyn_cast<Constant>(genConstValueExpression(ex));
       auto global = dyn_cast<GlobalVariable>(
           // @todo problem when two globals with same name
-          module.getOrInsertGlobal(var->name, getLLvmTypeFor(var->type.get(), var->location))
+          module.getOrInsertGlobal(var->name.str(), getLLvmTypeFor(var->type, var->location))
       );
       global->setInitializer(constant);
       var->llvmVariable = global;
@@ -169,15 +185,15 @@ class CodeGenerator {
       int i = 0;
       for (auto &memberVar : classDecl->variableDeclarations) {
         Type* llvmMemberType = nullptr;
-        auto type = memberVar->type.get();
+        auto type = memberVar->type;
         // member is class itself (value, not reference)
-        if (auto memberClassType = dynamic_cast<ClassType*>(type)) {
+        if (auto memberClassType = dyn_cast_or_null<ClassType>(type)) {
           auto memberClassDecl = memberClassType->classDeclaration;
           llvmMemberType = memberClassDecl->llvmStructType;
         }
         // member buildIn type
         else {
-          llvmMemberType = getLLvmTypeFor(memberVar->type.get(), memberVar->location);
+          llvmMemberType = getLLvmTypeFor(memberVar->type, memberVar->location);
         }
         if (llvmMemberType) {
           memberVarTypes.push_back(llvmMemberType);
@@ -188,8 +204,10 @@ class CodeGenerator {
       classDecl->llvmStructType->setBody(memberVarTypes);
 
       // member functions
-      for (auto &memberFunc : classDecl->functionDeclarations) {
-        genFunctionDeclaration(&memberFunc);
+      for (auto memberFunc : classDecl->functionDeclarations) {
+        if (reachable.contains(memberFunc)) {
+          genFunctionDeclaration(memberFunc);
+        }
       }
 
       cout << "-- class type: " << streamInString([&](llvm::raw_ostream &s) {
@@ -206,7 +224,7 @@ class CodeGenerator {
       bool ok = true;
       for (auto &memberVar : classDecl->variableDeclarations) {
         // member is class itself (value, not reference)
-        if (auto memberClassType = dynamic_cast<ClassType *>(memberVar->type.get())) {
+        if (auto memberClassType = dyn_cast_or_null<ClassType>(memberVar->type)) {
           auto memberClassDecl = memberClassType->classDeclaration;
           // loops like 'ClassA has member with type ClassB  and ClassB has member with type ClassA' are not allowed
           if (find(parentClassDecls.begin(), parentClassDecls.end(), memberClassDecl) != parentClassDecls.end()) {
@@ -232,14 +250,16 @@ class CodeGenerator {
      * Gen bodies of class member functions.
      */
     void genClassDeclMemberFunctions(ClassDeclaration *classDecl) {
-      for (auto &f : classDecl->functionDeclarations) {
-        genFunctionBody(&f);
+      for (auto f : classDecl->functionDeclarations) {
+        if (reachable.contains(f)) {
+          genFunctionBody(f);
+        }
       }
     }
 
 
     void genFunctionDeclaration(FunctionDeclaration *funcDecl, bool isMainFunction= false) {
-      auto returnType = getLLvmTypeFor(funcDecl->returnType.get(), funcDecl->location);
+      auto returnType = getLLvmTypeFor(funcDecl->returnType, funcDecl->location);
 
       // make function arguments
       std::vector<llvm::Type*> argTypes;
@@ -249,7 +269,7 @@ class CodeGenerator {
       }
       // functions args
       for (auto &arg : funcDecl->arguments) {
-        auto argType = getLLvmTypeFor(arg.type.get(), arg.location);
+        auto argType = getLLvmTypeFor(arg.type, arg.location);
         argTypes.push_back(argType);
       }
 
@@ -259,7 +279,7 @@ class CodeGenerator {
           argTypes,
           false);
 
-      auto name = funcDecl->isMemberFunction() ? funcDecl->parentClass->name + "_" + funcDecl->name : funcDecl->name;
+      auto name = funcDecl->isMemberFunction() ? funcDecl->parentClass->name + "_" + funcDecl->name : funcDecl->name.str();
       Function *func = Function::Create(
           funcType,
           GlobalValue::LinkageTypes::ExternalLinkage,
@@ -274,7 +294,7 @@ class CodeGenerator {
         funcArgsIter++;
       }
       for (auto &funcDeclArg : funcDecl->arguments) {
-        funcArgsIter->setName(funcDeclArg.name);
+        funcArgsIter->setName(funcDeclArg.name.str());
         funcArgsIter++;
       }
 
@@ -297,7 +317,7 @@ class CodeGenerator {
       auto funcArgsIter = func->args().begin();
       // create pointer to this argument if its a member function
       if (funcDecl->isMemberFunction()) {
-        auto thisVar = funcDecl->parentClass->thisVarDecl.get();
+        auto thisVar = funcDecl->parentClass->thisVarDecl;
         // store value to ptr
         //auto varPtr = builder.CreateAlloca(PointerType::get(funcDecl->parentClass->llvmStructType, 0), nullptr, "thisPtr");
         //builder.CreateStore(funcArgsIter, varPtr);
@@ -309,7 +329,7 @@ class CodeGenerator {
       auto funcDeclArgsIter = funcDecl->arguments.begin();
       for (;funcArgsIter != func->args().end(); funcArgsIter++) {
         // store value to ptr
-        auto varPtr = builder.CreateAlloca(getLLvmTypeFor(funcDeclArgsIter->type.get(), funcDecl->location), nullptr, funcDeclArgsIter->name + "Ptr");
+        auto varPtr = builder.CreateAlloca(getLLvmTypeFor(funcDeclArgsIter->type, funcDecl->location), nullptr, funcDeclArgsIter->name + "Ptr");
         builder.CreateStore(funcArgsIter, varPtr);
         funcDeclArgsIter->llvmVariable = varPtr;
         funcDeclArgsIter++;
@@ -317,7 +337,7 @@ class CodeGenerator {
 
       //builder.CreateRet(ConstantInt::get(context, APInt(32, 1, false)));
       // statements
-      genCompoundStatement(funcDecl->body.get());
+      genCompoundStatement(funcDecl->body);
 
       builder.ClearInsertionPoint();
       verifyFunction(*func, &errs());
@@ -328,43 +348,42 @@ class CodeGenerator {
      * @return true if statement is return
      */
     bool genStatement(Statement *statement) {
-      // return
-      if (auto* st = dynamic_cast<ReturnStatement*>(statement)) {
-        if (st->returnType->isVoidType()) {
-          builder.CreateRetVoid();
-        }
-        else {
-          auto value = genExpression(st->expression->get());
-          builder.CreateRet(value);
+      switch (statement->kind) {
+        // return
+        case Node_ReturnStatement: {
+          auto* st = cast<ReturnStatement>(statement);
+          if (st->returnType->isVoidType()) {
+            builder.CreateRetVoid();
+          }
+          else {
+            auto value = genExpression(st->expression);
+            builder.CreateRet(value);
+          }
+          return true;
         }
-        return true;
-      }
-      // variable declaration
-      else if (auto* st = dynamic_cast<VariableDeclaration*>(statement)) {
-        genVariableDeclaration(st);
-        return false;
-      }
-      // variable assign
-      else if (auto* st = dynamic_cast<VariableAssignStatement*>(statement)) {
-        genVariableAssignStatement(st);
-        return false;
-      }
-      // compound
-      else if (auto* st = dynamic_cast<CompoundStatement*>(statement)) {
-        return genCompoundStatement(st);
-      }
-      // if
-      else if (auto* st = dynamic_cast<IfStatement*>(statement)) {
-        return genIfStatement(st);
-      }
-      // while
-      else if (auto* st = dynamic_cast<WhileStatement*>(statement)) {
-        return genWhileStatement(st);
-      }
-      // expression
-      else if (auto* st = dynamic_cast<Expression*>(statement)) {
-        genExpression(st);
-        return false;
+        // variable declaration
+        case Node_VariableDeclaration:
+          genVariableDeclaration(cast<VariableDeclaration>(statement));
+          return false;
+        // variable assign
+        case Node_VariableAssignStatement:
+          genVariableAssignStatement(cast<VariableAssignStatement>(statement));
+          return false;
+        // compound
+        case Node_CompoundStatement:
+          return genCompoundStatement(cast<CompoundStatement>(statement));
+        // if
+        case Node_IfStatement:
+          return genIfStatement(cast<IfStatement>(statement));
+        // while
+        case Node_WhileStatement:
+          return genWhileStatement(cast<WhileStatement>(statement));
+        default:
+          // expression
+          if (auto* st = dyn_cast<Expression>(statement)) {
+            genExpression(st);
+            return false;
+          }
       }
 
       // abort compilation
@@ -374,12 +393,12 @@ class CodeGenerator {
 
 
     void genVariableDeclaration(VariableDeclaration *st) {
-      auto init = genExpression(st->initExpression.get());
+      auto init = genExpression(st->initExpression);
 
       // if is class type
-      if (auto classType = dynamic_cast<ClassType*>(st->type.get())) {
+      if (auto classType = dyn_cast_or_null<ClassType>(st->type)) {
         auto llvmType = classType->classDeclaration->llvmStructType;
-        auto var = builder.CreateAlloca(llvmType, nullptr, st->name);
+        auto var = builder.CreateAlloca(llvmType, nullptr, st->name.str());
         // copy init into var
         // @todo avoid copy when init is an R-value, for example a constructor call
         builder.CreateMemCpy(var, 0, init, 0, classType->classDeclaration->llvmStructSizeBytes);
@@ -389,7 +408,7 @@ class CodeGenerator {
 
 
       // is build type
-      auto typeBuildIn = getBuildInTypeFor(st->type.get(), st->location);
+      auto typeBuildIn = getBuildInTypeFor(st->type, st->location);
 
       cout << "- Var Decl: " << st->name << endl;
       cout << "-- init type: " << streamInString([&](llvm::raw_ostream &s) {
@@ -402,12 +421,12 @@ class CodeGenerator {
       // str
       if (typeBuildIn->type == BuildIn_str) {
         type = init->getType();
-        varPtr = builder.CreateAlloca(type, nullptr, st->name);
+        varPtr = builder.CreateAlloca(type, nullptr, st->name.str());
       }
       // buildIn
       else {
-        type = getLLvmTypeFor(st->type.get(), st->location);
-        varPtr = builder.CreateAlloca(type, nullptr, st->name);
+        type = getLLvmTypeFor(st->type, st->location);
+        varPtr = builder.CreateAlloca(type, nullptr, st->name.str());
       }
 
       // if init is str
@@ -430,7 +449,7 @@ class CodeGenerator {
      */
     bool genCompoundStatement(CompoundStatement *statement) {
       for (auto &st : statement->statements) {
-        bool isReturn = genStatement(st.get());
+        bool isReturn = genStatement(st);
         if (isReturn) {
           return true;
         }
@@ -440,12 +459,12 @@ class CodeGenerator {
 
 
     void genVariableAssignStatement(VariableAssignStatement *statement) {
-      auto type = statement->variableExpression->resultType.get();
-      auto variablePtr = genExpression(statement->variableExpression.get(), true);
-      auto value = genExpression(statement->valueExpression.get());
+      auto type = statement->variableExpression->resultType;
+      auto variablePtr = genExpression(statement->variableExpression, true);
+      auto value = genExpression(statement->valueExpression);
 
       // if is class type -> copy
-      if (auto classType = dynamic_cast<ClassType*>(statement->variableExpression->resultType.get())) {
+      if (auto classType = dyn_cast_or_null<ClassType>(statement->variableExpression->resultType)) {
         auto llvmType = classType->classDeclaration->llvmStructType;
         // copy value into var, @todo: instead of 0 in this call use MaybeAlign()
         builder.CreateMemCpy(variablePtr, 0, value, 0, classType->classDeclaration->llvmStructSizeBytes);
@@ -463,7 +482,7 @@ class CodeGenerator {
      * @return true when if and else body have return
      */
     bool genIfStatement(IfStatement *statement) {
-      auto conditionVal = genExpression(statement->condition.get());
+      auto conditionVal = genExpression(statement->condition);
       bool hasElse = !!statement->elseBody;
 
       // get the current function
@@ -487,7 +506,7 @@ class CodeGenerator {
       // create code for then
       bool hasReturn;
       builder.SetInsertPoint(thenBlock);
-      bool thenHasReturn = genCompoundStatement(statement->ifBody.get());
+      bool thenHasReturn = genCompoundStatement(statement->ifBody);
       if (!thenHasReturn) {
         builder.CreateBr(mergeBlock);
       }
@@ -496,7 +515,7 @@ class CodeGenerator {
       // create code for else
       if (hasElse) {
         builder.SetInsertPoint(elseBlock);
-        bool elseHasReturn = genCompoundStatement(statement->elseBody.get());
+        bool elseHasReturn = genCompoundStatement(statement->elseBody);
         if (!elseHasReturn) {
           builder.CreateBr(mergeBlock);
         }
@@ -533,12 +552,12 @@ class CodeGenerator {
 
       // create code for loop check
       builder.SetInsertPoint(checkBlock);
-      auto conditionVal = genExpression(statement->condition.get());
+      auto conditionVal = genExpression(statement->condition);
       builder.CreateCondBr(conditionVal, bodyBlock, mergeBlock);
 
       // create code for loop body
       builder.SetInsertPoint(bodyBlock);
-      bool hasReturn = genCompoundStatement(statement->body.get()); // could have return
+      bool hasReturn = genCompoundStatement(statement->body); // could have return
       if (!hasReturn) {
         builder.CreateBr(checkBlock);
       }
@@ -562,25 +581,29 @@ class CodeGenerator {
       * otherwise a load is performed and the value itself returned.
       */
     Value *genExpression(Expression *expression, bool returnPointer = false) {
-      // constant
-      if (auto* ex = dynamic_cast<ConstValueExpression*>(expression)) {
-        return genConstValueExpression(ex);
-      }
-      // call
-      else if (auto* ex = dynamic_cast<CallExpression*>(expression)) {
-        return genCallExpression(ex);
-      }
-      // unary
-      else if (auto* ex = dynamic_cast<UnaryExpression*>(expression)) {
-        return genUnaryExpression(ex);
-      }
-      // binary
-      else if (auto* ex = dynamic_cast<BinaryExpression*>(expression)) {
-        return genBinaryExpression(ex);
-      }
-      // variable
-      else if (auto* ex = dynamic_cast<VariableExpression*>(expression)) {
-        return genVariableExpression(ex, returnPointer);
+      switch (expression->kind) {
+        // constant
+        case Node_NumberIntExpression:
+        case Node_NumberFloatExpression:
+        case Node_BoolExpression:
+        case Node_StringExpression:
+          return genConstValueExpression(cast<ConstValueExpression>(expression));
+        // call
+        case Node_CallExpression:
+        case Node_MemberCallExpression:
+          return genCallExpression(cast<CallExpression>(expression));
+        // unary
+        case Node_UnaryExpression:
+          return genUnaryExpression(cast<UnaryExpression>(expression));
+        // binary
+        case Node_BinaryExpression:
+          return genBinaryExpression(cast<BinaryExpression>(expression));
+        // variable
+        case Node_VariableExpression:
+        case Node_MemberVariableExpression:
+          return genVariableExpression(cast<VariableExpression>(expression), returnPointer);
+        default:
+          break;
       }
 
       printError("code gen", "unsupported expression", expression->location);
@@ -598,8 +621,8 @@ class CodeGenerator {
      */
     Value *genVariableExpression(VariableExpression *expression, bool returnPointer) {
       // if is a member variable
-      if (auto memberVar = dynamic_cast<MemberVariableExpression*>(expression)) {
-        auto parentExprValue = genExpression(memberVar->parent.get(), false);
+      if (auto memberVar = dyn_cast<MemberVariableExpression>(expression)) {
+        auto parentExprValue = genExpression(memberVar->parent, false);
         auto parentClass = memberVar->variableDeclaration->parentClass;
         auto memberIndex = memberVar->variableDeclaration->memberIndex;
         // get member element from parent
@@ -631,7 +654,7 @@ class CodeGenerator {
 
 
     Value *genUnaryExpression(UnaryExpression *expression) {
-      auto inner = genExpression(expression->innerExpression.get());
+      auto inner = genExpression(expression->innerExpression);
       switch (expression->operation) {
         case Expr_Unary_Op_LOGIC_NOT:
           return builder.CreateNot(inner, "tmpNot");
@@ -641,14 +664,14 @@ class CodeGenerator {
 
 
     Value *genBinaryExpression(BinaryExpression *expression) {
-      auto resultType = dynamic_cast<BuildInType*>(expression->resultType.get());
-      auto operandType = dynamic_cast<BuildInType*>(expression->lhs->resultType.get());
+      auto resultType = dyn_cast_or_null<BuildInType>(expression->resultType);
+      auto operandType = dyn_cast_or_null<BuildInType>(expression->lhs->resultType);
       if (!resultType || !operandType) {
         throw CodeGenException("only buildIn types are currently supported", expression->location);
       }
 
-      auto lhs = genExpression(expression->lhs.get());
-      auto rhs = genExpression(expression->rhs.get());
+      auto lhs = genExpression(expression->lhs);
+      auto rhs = genExpression(expression->rhs);
 
 
       // when operation is compare
@@ -722,7 +745,7 @@ class CodeGenerator {
         if (expression->functionDeclaration->isConstructor) {
           return genConstructorCall(expression);
         }
-        else if (auto memberCall = dynamic_cast<MemberCallExpression*>(expression)) {
+        else if (auto memberCall = dyn_cast<MemberCallExpression>(expression)) {
           return genMemberCall(memberCall);
         }
         throw CodeGenException("expression not supported", expression->location);
@@ -731,7 +754,7 @@ class CodeGenerator {
       // make args
       vector<Value*> args;
       for (auto &arg: expression->argumentsNonNamed) {
-        args.push_back(genExpression(arg.expression.get()));
+        args.push_back(genExpression(arg.expression));
       }
       auto name = expression->functionDeclaration->returnType->isVoidType() ? "" : "call" + expression->functionDeclaration->name;
       return builder.CreateCall(expression->functionDeclaration->llvmFunction, args, name);
@@ -751,12 +774,12 @@ class CodeGenerator {
      */
     Value *genMemberCall(MemberCallExpression *expression) {
       auto functionDecl = expression->functionDeclaration;
-      auto parentValue = genExpression(expression->parent.get(), true); // return pointer to parent object, no copy
+      auto parentValue = genExpression(expression->parent, true); // return pointer to parent object, no copy
       // args
       vector<Value*> args;
       args.push_back(parentValue); // this arg
       for (auto &arg: expression->argumentsNonNamed) {
-        args.push_back(genExpression(arg.expression.get()));
+        args.push_back(genExpression(arg.expression));
       }
       auto name = expression->functionDeclaration->returnType->isVoidType() ? "" : "call" + expression->functionDeclaration->name;
       return builder.CreateCall(expression->functionDeclaration->llvmFunction, args, name);
@@ -764,17 +787,17 @@ class CodeGenerator {
 
 
     Value *genConstValueExpression(ConstValueExpression *expression) {
-      if (auto* ex = dynamic_cast<NumberIntExpression*>(expression)) {
-        return genConstIntExpression(ex);
-      }
-      else if (auto* ex = dynamic_cast<NumberFloatExpression*>(expression)) {
-        return genConstFloatExpression(ex);
-      }
-      else if (auto* ex = dynamic_cast<BoolExpression*>(expression)) {
-        return genConstBoolExpression(ex);
-      }
-      else if (auto* ex = dynamic_cast<StringExpression*>(expression)) {
-        return genConstStrExpression(ex);
+      switch (expression->kind) {
+        case Node_NumberIntExpression:
+          return genConstIntExpression(cast<NumberIntExpression>(expression));
+        case Node_NumberFloatExpression:
+          return genConstFloatExpression(cast<NumberFloatExpression>(expression));
+        case Node_BoolExpression:
+          return genConstBoolExpression(cast<BoolExpression>(expression));
+        case Node_StringExpression:
+          return genConstStrExpression(cast<StringExpression>(expression));
+        default:
+          break;
       }
 
       throw CodeGenException("unknown const value expression", expression->location);
@@ -826,7 +849,7 @@ class CodeGenerator {
     }
 
     BuildInType *getBuildInTypeFor(LangType *type, SrcLocationRange location) {
-      auto typeBuildIn = dynamic_cast<BuildInType*>(type);
+      auto typeBuildIn = dyn_cast_or_null<BuildInType>(type);
       if (!typeBuildIn) {
         throw CodeGenException("only buildIn types are currently supported", std::move(location));
       }
@@ -859,4 +882,6 @@ class CodeGenerator {
     llvm::DataLayout dataLayout;
 
     llvm::StructType* stringType;
+    /** code is only generated for reachable functions and classes */
+    ReachableDeclarations reachable;
 };
\ No newline at end of file
@@ -3,10 +3,14 @@
 
 #include <memory>
 #include <utility>
+#include <sstream>
 #include "../parser/AST.h"
+#include "../parser/Parser.h"
 #include "../Log.h"
 #include "NamesStack.h"
 #include "BinaryOpSupportedTypes.h"
+#include "ConstantFolder.h"
+#include "util/Parallel.h"
 
 using namespace std;
 
@@ -14,9 +18,79 @@ using namespace std;
 
 class AstDecorator {
   public:
+    AstDecorator() = default;
+
+    /**
+     * When enabled the bodies of classes and functions are decorated on multiple threads
+     * after all global names and signatures are known.
+     * Has no effect when function bodies are parsed lazily, then bodies are only decorated when they are reached.
+     */
+    void setParallelBodies(bool parallel) {
+      parallelBodies = parallel;
+    }
+
     bool linkNames(RootDeclarations &root) {
+      useRoot(root);
+      addGlobalNames(root);
+
+      // resolve class member signature
+      for (auto &classDecl : root.classDeclarations) {
+        doClassDeclarationSignature(classDecl);
+      }
+
+      // resolve functions return type and argument types
+      for (auto node : root.functionDeclarations) {
+        doFunctionDeclarationSignature(node);
+      }
+
+      // resolve vars type and init expressions
+      for (auto &varDecl : root.variableDeclarations) {
+        doVariableDeclaration(varDecl, true);
+      }
+
+      bool hasLazyBodies = any_of(root.functionDeclarations.begin(), root.functionDeclarations.end(), [](FunctionDeclaration *func) {
+        return func->hasUnparsedBody();
+      });
+      if (parallelBodies && !hasLazyBodies) {
+        doBodiesParallel(root);
+      }
+      else {
+        doBodies(root);
+      }
+
+
+      // if no main
+      if (!root.mainFunction) {
+        ::error("no main function has been provided, the main function needs the signature 'func main(): i32'");
+        errors++;
+      }
+
+      // return
+      return errors == 0;
+    }
+
+
+
+
+  private:
+    /**
+     * Setup decorating of the given ast.
+     */
+    void useRoot(RootDeclarations &root) {
+      // new nodes are added to the arena of the ast
+      arena = root.arena.get();
+      types = root.types.get();
+      this->root = &root;
+      requiredMainReturnType = types->getBuildInType(BuildIn_i32);
+      boolType = types->getBuildInType(BuildIn_bool);
+    }
+
+    /**
+     * Add the scope of global names with all global declarations.
+     */
+    void addGlobalNames(RootDeclarations &root) {
       // add top names scope for global names
-      NamesScope &globalScope = namesStack.addNamesScope();
+      NamesScope globalScope = namesStack.addNamesScope();
 
       // add vars to scope
       for (auto &var : root.variableDeclarations) {
@@ -26,10 +100,10 @@ class AstDecorator {
         }
       }
       // add functions to scope
-      for (auto &func : root.functionDeclarations) {
-        if (!globalScope.addName(func.name, func)) {
-          error("name '" + func.name + "' already declared", func.location)
-            .printMessage("name '" + func.name + "' previously declared here", globalScope.findName(func.name)->location);
+      for (auto func : root.functionDeclarations) {
+        if (!globalScope.addName(func->name, *func)) {
+          error("name '" + func->name + "' already declared", func->location)
+            .printMessage("name '" + func->name + "' previously declared here", globalScope.findName(func->name)->location);
           continue;
         }
       }
@@ -41,60 +115,100 @@ class AstDecorator {
           continue;
         }
       }
+    }
 
 
-      // resolve class member signature
-      for (auto &classDecl : root.classDeclarations) {
-        doClassDeclarationSignature(classDecl.get());
-      }
-
-      // resolve functions return type and argument types
-      for (auto &node : root.functionDeclarations) {
-        node.returnType = makeTypeForName(node.typeName, node.location);
-        // arguments
-        for (auto &arg : node.arguments) {
-          arg.type = makeTypeForName(arg.typeName, arg.location);
-          // default expression
-          if (arg.defaultExpression) {
-            doExpression(arg.defaultExpression.get(), true);
-          }
-        }
-      }
-
-      // resolve vars type and init expressions
-      for (auto &varDecl : root.variableDeclarations) {
-        doVariableDeclaration(varDecl.get(), true);
+    /**
+     * Decorate the bodies of classes and functions one after another.
+     */
+    void doBodies(RootDeclarations &root) {
+      // lazy parsed functions are only parsed and checked when they are reachable from main,
+      // the bodies of classes and functions may reach them before the loop over the functions
+      vector<bool> lazyBodies(root.functionDeclarations.size());
+      for (size_t i = 0; i < lazyBodies.size(); i++) {
+        lazyBodies[i] = root.functionDeclarations[i]->hasUnparsedBody();
       }
 
       // resolve class functions body
       for (auto &classDecl : root.classDeclarations) {
-        doClassDeclarationBody(classDecl.get());
+        doClassDeclarationBody(classDecl);
       }
 
       // resolve functions body
       // and search for main function
-      for (auto &func : root.functionDeclarations) {
-        bool isMain = doFunctionDeclarationBody(&func);
+      for (size_t i = 0; i < lazyBodies.size(); i++) {
+        auto func = root.functionDeclarations[i];
+        // a lazy body is checked once via reachedLazyFunctions, main is reached when no function called it before
+        if (lazyBodies[i]) {
+          if (func->name == "main" && func->hasUnparsedBody()) {
+            parseLazyFunctionBody(func);
+            reachedLazyFunctions.push_back(func);
+          }
+          continue;
+        }
+        bool isMain = doFunctionDeclarationBody(func);
         if (isMain) {
-          root.mainFunction = &func;
+          root.mainFunction = func;
         }
       }
+      // lazy parsed functions that are called by checked functions
+      while (!reachedLazyFunctions.empty()) {
+        auto func = reachedLazyFunctions.back();
+        reachedLazyFunctions.pop_back();
+        bool isMain = doFunctionDeclarationBody(func);
+        if (isMain) {
+          root.mainFunction = func;
+        }
+      }
+    }
 
 
-      // if no main
-      if (!root.mainFunction) {
-        ::error("no main function has been provided, the main function needs the signature 'func main(): i32'");
-        errors++;
+    /**
+     * Decorate the bodies of classes and functions on multiple threads.
+     * The global names and all signatures are complete at this point and are only read by the bodies,
+     * thus each chunk of bodies is decorated by its own worker with a local NamesStack on top of the global names,
+     * its own arena for new nodes and its own messages.
+     * The messages are printed afterwards in the order they would have been printed by doBodies().
+     */
+    void doBodiesParallel(RootDeclarations &root) {
+      size_t classesCount = root.classDeclarations.size();
+      size_t bodiesCount = classesCount + root.functionDeclarations.size();
+      unsigned threadsCount = getWorkerThreadsCount();
+      size_t chunksCount = min<size_t>(bodiesCount, threadsCount * CHUNKS_PER_THREAD);
+      sourceManager.prepareLineStarts();
+
+      vector<BodiesChunk> chunks(chunksCount);
+      parallelFor(chunksCount, [&](size_t chunkIndex) {
+        BodiesChunk &chunk = chunks[chunkIndex];
+        MessagesRedirect redirect(chunk.messages);
+        AstDecorator worker(*this, chunk.arena);
+        size_t end = (chunkIndex + 1) * bodiesCount / chunksCount;
+        for (size_t i = chunkIndex * bodiesCount / chunksCount; i < end; i++) {
+          if (i < classesCount) {
+            worker.doClassDeclarationBody(root.classDeclarations[i]);
+            continue;
+          }
+          auto func = root.functionDeclarations[i - classesCount];
+          if (worker.doFunctionDeclarationBody(func)) {
+            chunk.mainFunction = func;
+          }
+        }
+        chunk.errors = worker.errors;
+      }, threadsCount);
+
+      // join
+      for (auto &chunk : chunks) {
+        *messagesStream << chunk.messages.str();
+        errors += chunk.errors;
+        arena->merge(chunk.arena);
+        if (chunk.mainFunction) {
+          root.mainFunction = chunk.mainFunction;
+        }
       }
-
-      // return
-      return errors == 0;
     }
 
 
 
-
-  private:
     /**
      * @param isolated true if expression is part of assigment of a global variable
      *                 and no variable or call expressions are allowed
@@ -102,48 +216,50 @@ class AstDecorator {
      */
     bool doExpression(Expression *expression, bool isolated) {
       // check type of expression
-      if (auto* ex = dynamic_cast<NumberIntExpression*>(expression)) {
-        ex->resultType = make_unique<BuildInType>(BuildIn_i32);
-        return true;
-      }
-      else if (auto* ex = dynamic_cast<NumberFloatExpression*>(expression)) {
-        ex->resultType = make_unique<BuildInType>(BuildIn_f32);
-        return true;
-      }
-      else if (auto* ex = dynamic_cast<BoolExpression*>(expression)) {
-        ex->resultType = make_unique<BuildInType>(BuildIn_bool);
-        return true;
-      }
-      else if (auto* ex = dynamic_cast<StringExpression*>(expression)) {
-        ex->resultType = make_unique<BuildInType>(BuildIn_str);
-        return true;
-      }
-      else if (auto* ex = dynamic_cast<UnaryExpression*>(expression)) {
-        return doUnaryExpression(ex, isolated);
-      }
-      // variable expression
-      else if (auto* ex = dynamic_cast<VariableExpression*>(expression)) {
-        if (!isolated) {
-          return doVariableExpression(ex, isolated);
-        }
-        else {
-          error("usage of other variables is not allowed here", ex->location);
-          return false;
-        }
-      }
-      // call expression
-      else if (auto* ex = dynamic_cast<CallExpression*>(expression)) {
-        if (!isolated) {
-          return doCallExpression(ex, isolated);
-        }
-        else {
-          error("usage of function calls is not allowed here", ex->location);
-          return false;
-        }
-      }
-      // binary expression
-      else if (auto* ex = dynamic_cast<BinaryExpression*>(expression)) {
-        return doBinaryExpression(ex, isolated);
+      switch (expression->kind) {
+        case Node_NumberIntExpression:
+          expression->resultType = types->getBuildInType(BuildIn_i32);
+          return true;
+        case Node_NumberFloatExpression:
+          expression->resultType = types->getBuildInType(BuildIn_f32);
+          return true;
+        case Node_BoolExpression:
+          expression->resultType = types->getBuildInType(BuildIn_bool);
+          return true;
+        case Node_StringExpression:
+          expression->resultType = types->getBuildInType(BuildIn_str);
+          return true;
+        case Node_UnaryExpression:
+          return doUnaryExpression(cast<UnaryExpression>(expression), isolated);
+
+        // variable expression
+        case Node_VariableExpression:
+        case Node_MemberVariableExpression:
+          if (!isolated) {
+            return doVariableExpression(cast<VariableExpression>(expression), isolated);
+          }
+          else {
+            error("usage of other variables is not allowed here", expression->location);
+            return false;
+          }
+
+        // call expression
+        case Node_CallExpression:
+        case Node_MemberCallExpression:
+          if (!isolated) {
+            return doCallExpression(cast<CallExpression>(expression), isolated);
+          }
+          else {
+            error("usage of function calls is not allowed here", expression->location);
+            return false;
+          }
+
+        // binary expression
+        case Node_BinaryExpression:
+          return doBinaryExpression(cast<BinaryExpression>(expression), isolated);
+
+        default:
+          break;
       }
 
       error("unsupported expression ", expression->location);
@@ -160,15 +276,15 @@ class AstDecorator {
      * @return false if there is a error in expression, this will prevent continuing of checking
      */
     bool doUnaryExpression(UnaryExpression *ex, bool isolated) {
-      auto innerOk = doExpression(ex->innerExpression.get(), isolated);
+      auto innerOk = doExpression(ex->innerExpression, isolated);
       if (!innerOk) {
         return false;
       }
       // check type
       if (ex->operation == Expr_Unary_Op_LOGIC_NOT) {
-        ex->resultType = make_unique<BuildInType>(BuildIn_bool);
+        ex->resultType = types->getBuildInType(BuildIn_bool);
         // inner is not bool
-        if (!ex->innerExpression->resultType->equals(boolType.get())) {
+        if (!ex->innerExpression->resultType->equals(boolType)) {
           error("type '"+ ex->innerExpression->resultType->toString() +"' of inner expression is not required type '"+boolType->toString()+"' for unary expression '"
                     + string(magic_enum::enum_name(ex->operation))+ "'",
                 ex->location);
@@ -190,17 +306,17 @@ class AstDecorator {
      * @return false if there is a error in expression, this will prevent continuing of checking
      */
     bool doBinaryExpression(BinaryExpression *ex, bool isolated) {
-      bool lhsOk = doExpression(ex->lhs.get(), isolated);
-      bool rhsOk = doExpression(ex->rhs.get(), isolated);
+      bool lhsOk = doExpression(ex->lhs, isolated);
+      bool rhsOk = doExpression(ex->rhs, isolated);
       if (!lhsOk || !rhsOk){
         return false;
       }
       // compare types of lhs and rhs
-      auto lhsType = ex->lhs->resultType.get();
-      auto rhsType = ex->rhs->resultType.get();
+      auto lhsType = ex->lhs->resultType;
+      auto rhsType = ex->rhs->resultType;
       if (lhsType->equals(rhsType)) {
         // check result type
-        ex->resultType = binaryOperationResultType(lhsType, ex->operation);
+        ex->resultType = binaryOperationResultType(lhsType, ex->operation, *types);
         if (ex->resultType->isInvalid()) {
           error("type '"+ ex->lhs->resultType->toString() +"' does not support binary expression '"
                     + string(magic_enum::enum_name(ex->operation))+ "'",
@@ -227,16 +343,17 @@ class AstDecorator {
      */
     bool doVariableExpression(VariableExpression *ex, bool isolated){
       // if is member var: used from outside of the class like 'myObject.myVar'
-      if (auto* memberVar = dynamic_cast<MemberVariableExpression*>(ex)) {
-        if (!doExpression(memberVar->parent.get(), isolated))
+      if (auto* memberVar = dyn_cast<MemberVariableExpression>(ex)) {
+        if (!doExpression(memberVar->parent, isolated))
           return false;
-        auto parentClassType= dynamic_cast<ClassType*>(memberVar->parent->resultType.get());
+        auto parentClassType= dyn_cast_or_null<ClassType>(memberVar->parent->resultType);
         if (!parentClassType) {
           error("type '" + memberVar->parent->resultType->toString() + "' is not a class type and can't have members, thus member '"+ex->name+"' was not found",
                 memberVar->parent->location);
           return false;
         }
         // find member
+        useGlobalName(parentClassType->classDeclaration->name);
         auto memberDecl = parentClassType->classDeclaration->findMemberVariable(ex->name);
         if (!memberDecl) {
           error("class '" + parentClassType->classDeclaration->name + "' has no member with name '"+ex->name+"'", ex->location)
@@ -244,17 +361,17 @@ class AstDecorator {
           return false;
         }
         ex->variableDeclaration = memberDecl;
-        ex->resultType = memberDecl->type->clone();
+        ex->resultType = memberDecl->type;
         return true;
       }
       // not a member var
       else {
-        auto node = namesStack.findName(ex->name);
+        auto node = findName(ex->name);
         if (!node) {
           error("name '" + ex->name + "' not found in current scope", ex->location);
           return false;
         }
-        auto varDecl = dynamic_cast<AbstractVariableDeclaration *>(node);
+        auto varDecl = AbstractVariableDeclaration::fromNode(node);
         if (!varDecl) {
           error("'" + ex->name + "' is not a declared Variable", ex->location);
           return false;
@@ -263,31 +380,31 @@ class AstDecorator {
         if (varDecl->isMemberVariable()) {
           // create MemberVariableExpression that points to this of class
           // and replace ex with it
-          unique_ptr<MemberVariableExpression> memberExpr = make_unique<MemberVariableExpression>();
+          auto memberExpr = arena->make<MemberVariableExpression>();
           memberExpr->location = ex->location;
           memberExpr->variableDeclaration = ex->variableDeclaration;
           memberExpr->name = ex->name;
           memberExpr->parentAstNode = ex->parentAstNode;
           // parent is this
-          auto thisParent = make_unique<VariableExpression>();
-          thisParent->variableDeclaration = varDecl->parentClass->thisVarDecl.get();
+          auto thisParent = arena->make<VariableExpression>();
+          thisParent->variableDeclaration = varDecl->parentClass->thisVarDecl;
           thisParent->name = "this";
           thisParent->location = ex->location;
-          thisParent->resultType = thisParent->variableDeclaration->type->clone();
-          thisParent->parentAstNode = memberExpr.get();
-          memberExpr->parent = move(thisParent);
+          thisParent->resultType = thisParent->variableDeclaration->type;
+          thisParent->parentAstNode = memberExpr;
+          memberExpr->parent = thisParent;
 
           // replace ex with memberExpr
-          // this will delete the old ex
+          // the old ex stays unused in the arena
           // fix ex pointer, now points to memberExpr
-          ex = ex->replaceNode(move(memberExpr));
+          ex = ex->replaceNode(memberExpr);
         }
 
         ex->variableDeclaration = varDecl;
         if (!varDecl->type) {
           return false;
         }
-        ex->resultType = varDecl->type->clone();
+        ex->resultType = varDecl->type;
         return true;
       }
     }
@@ -303,6 +420,10 @@ class AstDecorator {
       if (!func) {
         return false;
       }
+      // called function is reachable, check its body later when the current function is done
+      if (func->hasUnparsedBody() && parseLazyFunctionBody(func)) {
+        reachedLazyFunctions.push_back(func);
+      }
 
       if (!func->returnType) {
         //return false;
@@ -377,7 +498,7 @@ class AstDecorator {
         }
 
         // check if arg has default value
-        Expression *defaultExpr = func->arguments[i].defaultExpression.get();
+        Expression *defaultExpr = func->arguments[i].defaultExpression;
         if (!defaultExpr) {
           error("function argument '"+func->arguments[i].name+"' of function '" + func->name + "' is required but has not been provided at function call",
                 call->location)
@@ -387,14 +508,14 @@ class AstDecorator {
         // has default expr
         else {
           CallExpressionArgument newArg = CallExpressionArgument();
-          auto defaultExprConst = dynamic_cast<ConstValueExpression*>(defaultExpr);
+          auto defaultExprConst = dyn_cast<ConstValueExpression>(defaultExpr);
           if (!defaultExprConst) {
             error("only const values are supported for default function arguments", defaultExpr->location);
             continue;
           }
 
           // expression now shared with function declaration argument
-          newArg.expression = defaultExprConst->clone();
+          newArg.expression = defaultExprConst->clone(*arena);
           newArg.location = call->location;
           newArg.argumentDeclaration = &func->arguments[i];
           callArgs[i] = move(newArg);
@@ -403,6 +524,11 @@ class AstDecorator {
       // set computed args
       call->argumentsNonNamed = move(callArgs);
       call->argumentsNamed.resize(0);
+      // the args moved, link them again
+      for (auto &arg : call->argumentsNonNamed) {
+        linkChild(call, &arg);
+        linkChild(&arg, arg.expression);
+      }
 
       // aboard when error occurred
       if (!ok) {
@@ -415,7 +541,7 @@ class AstDecorator {
         return false;
       }
       else {
-        call->resultType = func->returnType->clone();
+        call->resultType = func->returnType;
         call->functionDeclaration = func;
       }
 
@@ -431,16 +557,17 @@ class AstDecorator {
     FunctionDeclaration *resolveFunctionDeclOfCall(CallExpression *call, bool isolated) {
       FunctionDeclaration* func = nullptr;
       // if is member call
-      if (auto* memberCall = dynamic_cast<MemberCallExpression*>(call)) {
-        if (!doExpression(memberCall->parent.get(), isolated))
+      if (auto* memberCall = dyn_cast<MemberCallExpression>(call)) {
+        if (!doExpression(memberCall->parent, isolated))
           return nullptr;
-        auto parentClassType= dynamic_cast<ClassType*>(memberCall->parent->resultType.get());
+        auto parentClassType= dyn_cast_or_null<ClassType>(memberCall->parent->resultType);
         if (!parentClassType) {
           error("type '" + memberCall->parent->resultType->toString() + "' is not a class type and can't have members, thus member function '"+call->calledName+"' was not found",
               memberCall->parent->location);
           return nullptr;
         }
         // find member
+        useGlobalName(parentClassType->classDeclaration->name);
         auto memberDecl = parentClassType->classDeclaration->findMemberFunction(call->calledName);
         if (!memberDecl) {
           error("class '" + parentClassType->classDeclaration->name + "' has no member function with name '"+call->calledName+"'", call->location)
@@ -451,12 +578,12 @@ class AstDecorator {
       }
       // NOT a member call
       else {
-        auto foundNode = namesStack.findName(call->calledName);
-        func = dynamic_cast<FunctionDeclaration *>(foundNode);
+        auto foundNode = findName(call->calledName);
+        func = dyn_cast_or_null<FunctionDeclaration>(foundNode);
         // check if its a constructor
-        if (auto classDecl = dynamic_cast<ClassDeclaration *>(foundNode))
+        if (auto classDecl = dyn_cast_or_null<ClassDeclaration>(foundNode))
         {
-          func = classDecl->constructor.get();
+          func = classDecl->constructor;
         }
       }
       if (!func){
@@ -471,8 +598,8 @@ class AstDecorator {
                                   const CallExpressionArgument &arg,
                                   int callArgIndex) {
       // check type of expression
-      if (doExpression(arg.expression.get(), false)) {
-        auto funcArgType = func->arguments.at(callArgIndex).type.get();
+      if (doExpression(arg.expression, false)) {
+        auto funcArgType = func->arguments.at(callArgIndex).type;
         if (!arg.expression->resultType->equals(funcArgType)) {
           error("function argument '"+*arg.argName+"' of function '" + func->name + "' needs type '"+ funcArgType->toString() +"' "+
                 "but assigned expression has type '"+ arg.expression->resultType->toString() +"'",
@@ -498,45 +625,46 @@ class AstDecorator {
      * @return true when statement is a return statement or it contains a return statement
      */
     bool doStatement(Statement *statement, NamesScope &scope, LangType *expectedTypeForReturn) {
-      // return
-      if (auto* st = dynamic_cast<ReturnStatement*>(statement)) {
-        doReturnStatement(st, expectedTypeForReturn);
-        return true;
-      }
-      // variable declaration
-      else if (auto* st = dynamic_cast<VariableDeclaration*>(statement)) {
-        doVariableDeclaration(st, false);
-        if (!scope.addName(st->name, *st)) {
-          error("name '" + st->name + "' already declared", st->location)
-              .printMessage("name '" + st->name + "' previously declared here", scope.findName(st->name)->location);
+      switch (statement->kind) {
+        // return
+        case Node_ReturnStatement:
+          doReturnStatement(cast<ReturnStatement>(statement), expectedTypeForReturn);
+          return true;
+
+        // variable declaration
+        case Node_VariableDeclaration: {
+          auto* st = cast<VariableDeclaration>(statement);
+          doVariableDeclaration(st, false);
+          if (!scope.addName(st->name, *st)) {
+            error("name '" + st->name + "' already declared", st->location)
+                .printMessage("name '" + st->name + "' previously declared here", scope.findName(st->name)->location);
+          }
+          return false;
         }
-        return false;
-      }
-      // compound statement
-      else if (auto* st = dynamic_cast<CompoundStatement*>(statement)) {
-        return doCompoundStatementWithNewScope(st, expectedTypeForReturn);
-      }
-      // if statement
-      else if (auto* st = dynamic_cast<IfStatement*>(statement)) {
-        return doIfStatement(st, expectedTypeForReturn);
-      }
-      // while statement
-      else if (auto* st = dynamic_cast<WhileStatement*>(statement)) {
-        return doWhileStatement(st, expectedTypeForReturn);
-      }
-      // variable assign statement
-      else if (auto* st = dynamic_cast<VariableAssignStatement*>(statement)) {
-        doVariableAssignStatement(st);
-        return false;
-      }
-      // expression statement
-      else if (auto* st = dynamic_cast<Expression*>(statement)) {
-        doExpression(st, false);
-        return false;
-      }
-      else {
-        error("unsupported statement", statement->location);
-        return false;
+
+        // compound statement
+        case Node_CompoundStatement:
+          return doCompoundStatementWithNewScope(cast<CompoundStatement>(statement), expectedTypeForReturn);
+        // if statement
+        case Node_IfStatement:
+          return doIfStatement(cast<IfStatement>(statement), expectedTypeForReturn);
+        // while statement
+        case Node_WhileStatement:
+          return doWhileStatement(cast<WhileStatement>(statement), expectedTypeForReturn);
+
+        // variable assign statement
+        case Node_VariableAssignStatement:
+          doVariableAssignStatement(cast<VariableAssignStatement>(statement));
+          return false;
+
+        default:
+          // expression statement
+          if (auto* st = dyn_cast<Expression>(statement)) {
+            doExpression(st, false);
+            return false;
+          }
+          error("unsupported statement", statement->location);
+          return false;
       }
     }
 
@@ -544,14 +672,14 @@ class AstDecorator {
     void doReturnStatement(ReturnStatement *st, LangType *expectedTypeForReturn) {
       // is void
       if (!st->expression) {
-        st->returnType = make_unique<BuildInType>(BuildIn_void);
+        st->returnType = types->getBuildInType(BuildIn_void);
       }
       // is non void
       else {
-        bool exprOk = doExpression(st->expression->get(), false);
+        bool exprOk = doExpression(st->expression, false);
         if (!exprOk)
           return;
-        st->returnType = st->expression->get()->resultType->clone();
+        st->returnType = st->expression->resultType;
       }
       // type check
       if (!st->returnType->equals(expectedTypeForReturn)) {
@@ -572,7 +700,7 @@ class AstDecorator {
         if (hasReturn) {
           printWarn("", "statement is after return and will be ignored", statement->location);
         }
-        bool currentHasReturn = doStatement(statement.get(), scope, expectedTypeForReturn);
+        bool currentHasReturn = doStatement(statement, scope, expectedTypeForReturn);
         hasReturn = hasReturn || currentHasReturn;
       }
       return hasReturn;
@@ -583,7 +711,7 @@ class AstDecorator {
      * @return true if it contains a return statement
      */
     bool doCompoundStatementWithNewScope(CompoundStatement *st, LangType *expectedTypeForReturn) {
-      NamesScope &compScope = namesStack.addNamesScope();
+      NamesScope compScope = namesStack.addNamesScope();
       bool hasReturn = doCompoundStatement(st, compScope, expectedTypeForReturn);
       namesStack.removeNamesScope(compScope);
       return hasReturn;
@@ -591,16 +719,16 @@ class AstDecorator {
 
 
     bool doIfStatement(IfStatement *st, LangType *expectedTypeForReturn) {
-      if (doExpression(st->condition.get(), false)) {
-        if (!st->condition->resultType->equals(boolType.get())) {
+      if (doExpression(st->condition, false)) {
+        if (!st->condition->resultType->equals(boolType)) {
           error("condition of if has to be of type bool, but is '"+st->condition->resultType->toString()+"'",
               st->condition->location);
         }
       }
 
-      bool hasReturn = doCompoundStatementWithNewScope(st->ifBody.get(), expectedTypeForReturn);
+      bool hasReturn = doCompoundStatementWithNewScope(st->ifBody, expectedTypeForReturn);
       if (st->elseBody) {
-        bool elseHasReturn = doCompoundStatementWithNewScope(st->elseBody.get(), expectedTypeForReturn);
+        bool elseHasReturn = doCompoundStatementWithNewScope(st->elseBody, expectedTypeForReturn);
         hasReturn = hasReturn && elseHasReturn;
       }
       return hasReturn;
@@ -608,21 +736,21 @@ class AstDecorator {
 
 
     bool doWhileStatement(WhileStatement *st, LangType *expectedTypeForReturn) {
-      if (doExpression(st->condition.get(), false)) {
-        if (!st->condition->resultType->equals(boolType.get())) {
+      if (doExpression(st->condition, false)) {
+        if (!st->condition->resultType->equals(boolType)) {
           error("condition of if has to be of type bool, but is '"+st->condition->resultType->toString()+"'",
                 st->condition->location);
         }
       }
 
-      doCompoundStatementWithNewScope(st->body.get(), expectedTypeForReturn);
+      doCompoundStatementWithNewScope(st->body, expectedTypeForReturn);
       // condition could jump over the body if its initial false
       return false;
     }
 
 
     void doVariableAssignStatement(VariableAssignStatement *st) {
-      if (!doVariableExpression(st->variableExpression.get(), false))
+      if (!doVariableExpression(st->variableExpression, false))
         return;
       if (!st->variableExpression->variableDeclaration->isMutable) {
         error("can't assign a value to a non mutable variable '"
@@ -630,11 +758,11 @@ class AstDecorator {
               st->location);
       }
 
-      if (!doExpression(st->valueExpression.get(), false))
+      if (!doExpression(st->valueExpression, false))
         return;
       // check types
-      auto varType = st->variableExpression->resultType.get();
-      auto valType = st->valueExpression->resultType.get();
+      auto varType = st->variableExpression->resultType;
+      auto valType = st->valueExpression->resultType;
       if (!varType->equals(valType)) {
         error("operand types of variable assignment are not the same: variable type '"
                   + varType->toString() + "' and value type '"
@@ -651,34 +779,44 @@ class AstDecorator {
      */
     void doClassDeclarationSignature(ClassDeclaration *classDecl) {
       // resolve functions return type and argument types
-      for (auto &node : classDecl->functionDeclarations) {
-        node.returnType = makeTypeForName(node.typeName, node.location);
-        // arguments
-        for (auto &arg : node.arguments) {
-          arg.type = makeTypeForName(arg.typeName, arg.location);
-          // default expression
-          if (arg.defaultExpression) {
-            doExpression(arg.defaultExpression.get(), true);
-          }
-        }
-
+      for (auto node : classDecl->functionDeclarations) {
+        doFunctionDeclarationSignature(node);
+      }
+      // add this arg, keep it when the signature is resolved again
+      if (!classDecl->thisVarDecl) {
+        classDecl->thisVarDecl = arena->make<VariableDeclaration>();
+        classDecl->thisVarDecl->name = "this";
+        classDecl->thisVarDecl->parentAstNode = classDecl;
       }
-      // add this arg
-      classDecl->thisVarDecl = make_unique<VariableDeclaration>();
-      classDecl->thisVarDecl->name = "this";
       classDecl->thisVarDecl->location = classDecl->location;
       // @todo this should be ReferenceType<ClassType>
-      classDecl->thisVarDecl->type = make_unique<ClassType>(classDecl);
+      classDecl->thisVarDecl->type = types->getClassType(classDecl);
 
       // add default constructor
       classDecl->constructor->name = classDecl->name + "_default_constructor";
       classDecl->constructor->parentClass = classDecl;
       classDecl->constructor->isConstructor = true;
-      classDecl->constructor->returnType = make_unique<ClassType>(classDecl);
+      classDecl->constructor->returnType = types->getClassType(classDecl);
 
       // resolve vars type and init expressions
       for (auto &varDecl : classDecl->variableDeclarations) {
-        doVariableDeclaration(varDecl.get(), true, false);
+        doVariableDeclaration(varDecl, true, false);
+      }
+    }
+
+
+    /**
+     * Resolve return type and argument types of a function.
+     */
+    void doFunctionDeclarationSignature(FunctionDeclaration *func) {
+      func->returnType = makeTypeForName(func->typeName, func->location);
+      // arguments
+      for (auto &arg : func->arguments) {
+        arg.type = makeTypeForName(arg.typeName, arg.location);
+        // default expression
+        if (arg.defaultExpression) {
+          doExpression(arg.defaultExpression, true);
+        }
       }
     }
 
@@ -690,24 +828,41 @@ class AstDecorator {
     void doClassDeclarationBody(ClassDeclaration *classDecl) {
       // new class scope
       // add member vars and functions to that scope
-      NamesScope &classScope = namesStack.addNamesScope();
+      NamesScope classScope = namesStack.addNamesScope();
       for (auto &varDecl : classDecl->variableDeclarations) {
         addNameToScope(classScope, varDecl->name, *varDecl);
       }
       // add this var to scope
       addNameToScope(classScope, "this", *classDecl->thisVarDecl);
       // func signature
-      for (auto &funcDecl : classDecl->functionDeclarations) {
-        addNameToScope(classScope, funcDecl.name, funcDecl);
+      for (auto funcDecl : classDecl->functionDeclarations) {
+        addNameToScope(classScope, funcDecl->name, *funcDecl);
       }
       // functions body
-      for (auto &funcDecl : classDecl->functionDeclarations) {
-        doFunctionDeclarationBody(&funcDecl);
+      for (auto funcDecl : classDecl->functionDeclarations) {
+        doFunctionDeclarationBody(funcDecl);
       }
       namesStack.removeNamesScope(classScope);
     }
 
 
+    /**
+     * Parse the body of a function if it was skipped by the parser.
+     * @return false if there is a parse error in the body
+     */
+    bool parseLazyFunctionBody(FunctionDeclaration *func) {
+      try {
+        Parser::parseLazyFunctionBody(*root, func);
+      }
+      catch (ParseException &e) {
+        errors++;
+        printError("parse", e.what(), e.token.location);
+        return false;
+      }
+      return true;
+    }
+
+
     /**
      * This will not do the func arguments and return type, this has to be setup before.
      * @return true if func is the main function otherwise false
@@ -719,33 +874,42 @@ class AstDecorator {
       }
 
       bool isMain = false;
+      int errorsBefore = errors;
       // new function scope
       // add arguments to that scope
-      NamesScope &funcScope = namesStack.addNamesScope();
+      NamesScope funcScope = namesStack.addNamesScope();
       for (auto &arg : func->arguments) {
         funcScope.addName(arg.name, arg);
       }
 
       // body
       if (func->body) {
-        bool hasReturn = doCompoundStatement(func->body.get(), funcScope, func->returnType.get());
+        bool hasReturn = doCompoundStatement(func->body, funcScope, func->returnType);
         // check return
         if (!hasReturn) {
           if (func->returnType->isVoidType()) {
             // insert implicit return void
-            auto ret = make_unique<ReturnStatement>();
-            ret->returnType = make_unique<BuildInType>(BuildIn_void);
-            func->body->statements.push_back(move(ret));
+            auto ret = arena->make<ReturnStatement>();
+            ret->returnType = types->getBuildInType(BuildIn_void);
+            func->body->statements.push_back(ret);
+            // the statements may have been moved, link them again
+            for (auto &statement : func->body->statements) {
+              linkChild(func->body, statement);
+            }
           }
           else {
             error("a non void function has to return something at the end", func->location);
           }
         }
+        // only bodies without errors have all types to fold them
+        if (errors == errorsBefore) {
+          ConstantFolder(*arena).foldFunctionBody(func);
+        }
       }
 
       // check for main function
       if (func->name == "main") {
-        if (func->arguments.empty() && func->returnType->equals(requiredMainReturnType.get())) {
+        if (func->arguments.empty() && func->returnType->equals(requiredMainReturnType)) {
           isMain = true;
         }
         else {
@@ -763,7 +927,7 @@ class AstDecorator {
      * Will not add var to namesScope.
      */
     void doVariableDeclaration(VariableDeclaration *varDecl, bool constInit, bool needsInit = true) {
-      auto initExpr = varDecl->initExpression.get();
+      auto initExpr = varDecl->initExpression;
       if (!initExpr && needsInit) {
         error("variable needs an init expression but got none",varDecl->location);
         return;
@@ -771,17 +935,18 @@ class AstDecorator {
       // check init expr
       LangType *initExprType;
       if (initExpr) {
-        if (constInit) {
-          if (!dynamic_cast<ConstValueExpression*>(varDecl->initExpression.get())) {
+        // resolve initExpression
+        bool initOk = doExpression(varDecl->initExpression, constInit);
+        if (initOk && constInit) {
+          // constant expressions like '60 * 60' are folded into a single value
+          ConstantFolder(*arena).foldExpression(varDecl->initExpression);
+          if (!isa<ConstValueExpression>(varDecl->initExpression)) {
             error("global variable need to have a constant init expression, this expression is not constant",
                   varDecl->initExpression->location);
             return;
           }
         }
-
-        // resolve initExpression
-        bool initOk = doExpression(varDecl->initExpression.get(), constInit);
-        initExprType = varDecl->initExpression->resultType.get();
+        initExprType = varDecl->initExpression->resultType;
         if (!initOk || !initExprType)
           return;
       }
@@ -792,7 +957,7 @@ class AstDecorator {
         varDecl->type = makeTypeForName(varDecl->typeName, varDecl->location);
         // check type of init
         if (initExpr) {
-          if (!initExprType->equals(varDecl->type.get())) {
+          if (!initExprType->equals(varDecl->type)) {
             error("specified type of variable '"+ varDecl->type->toString() +"' "
                       +"dose not not matches type of init expression '"+ initExprType->toString() +"'", varDecl->location);
           }
@@ -800,7 +965,7 @@ class AstDecorator {
       }
       // infer type by init expression
       else if (initExpr) {
-        varDecl->type = initExprType->clone();
+        varDecl->type = initExprType;
       }
       else {
         error("variable '"+varDecl->name+"' needs a type, but no explicit type was provided or could be inferred from a init expression", varDecl->location);
@@ -811,10 +976,44 @@ class AstDecorator {
 
 
   private:
+    /** chunks of bodies per thread when decorating in parallel, more chunks than threads balance bodies of different size */
+    static constexpr size_t CHUNKS_PER_THREAD = 4;
+
+    /**
+     * Result of a worker that decorates a part of the bodies in parallel.
+     */
+    struct BodiesChunk {
+        AstArena arena;
+        ostringstream messages;
+        int errors = 0;
+        FunctionDeclaration *mainFunction = nullptr;
+    };
+
     NamesStack namesStack;
+    /** arena of the ast that is decorated */
+    AstArena *arena = nullptr;
     int errors = 0;
-    unique_ptr<BuildInType> requiredMainReturnType = make_unique<BuildInType>(BuildIn_i32);
-    unique_ptr<BuildInType> boolType = make_unique<BuildInType>(BuildIn_bool);
+    RootDeclarations *root = nullptr;
+    /** lazy parsed functions whose body is parsed but not checked yet */
+    vector<FunctionDeclaration*> reachedLazyFunctions;
+    /** types of the ast that is decorated */
+    TypeContext *types = nullptr;
+    BuildInType *requiredMainReturnType = nullptr;
+    BuildInType *boolType = nullptr;
+    bool parallelBodies = false;
+    /** when set, the names that are resolved in the global scope or not found are added to it */
+    vector<Symbol> *usedGlobalNames = nullptr;
+
+    friend class IncrementalDecorator;
+
+    /**
+     * Worker that decorates bodies with the global names and types of the parent,
+     * new nodes are created in the given arena.
+     */
+    AstDecorator(const AstDecorator &parent, AstArena &arena)
+        : namesStack(&parent.namesStack), arena(&arena), root(parent.root), types(parent.types),
+          requiredMainReturnType(parent.requiredMainReturnType), boolType(parent.boolType)
+    {}
 
     MsgScope error(
         const string& msg,
@@ -825,16 +1024,17 @@ class AstDecorator {
     }
 
 
-    static BUILD_IN_TYPE typeNameToBuildIn(string typeName) {
-      if (typeName == "i32")
+    static BUILD_IN_TYPE typeNameToBuildIn(const Symbol &typeName) {
+      static const Symbol i32 = "i32", f32 = "f32", voidName = "void", boolName = "bool", str = "str";
+      if (typeName == i32)
         return BuildIn_i32;
-      if (typeName == "f32")
+      if (typeName == f32)
         return BuildIn_f32;
-      if (typeName == "void")
+      if (typeName == voidName)
         return BuildIn_void;
-      if (typeName == "bool")
+      if (typeName == boolName)
         return BuildIn_bool;
-      if (typeName == "str")
+      if (typeName == str)
         return BuildIn_str;
       return BuildIn_No_BuildIn;
     }
@@ -844,26 +1044,45 @@ class AstDecorator {
      * make type
      * prints error and returns null if type not found.
      */
-    unique_ptr<LangType> makeTypeForName(string &name, SrcLocationRange &location) {
+    LangType *makeTypeForName(const Symbol &name, SrcLocationRange &location) {
       BUILD_IN_TYPE buildIn = typeNameToBuildIn(name);
       if (buildIn != BuildIn_No_BuildIn)
       {
-        auto type = make_unique<BuildInType>(buildIn);
-        return move(type);
+        return types->getBuildInType(buildIn);
       }
       // user defined type
       else {
-        auto found = namesStack.findName(name);
+        auto found = findName(name);
         if (!found) {
           error("could not find type with name '" + name+ "'", location);
           return nullptr;
         }
-        auto classDecl = dynamic_cast<ClassDeclaration*>(found);
+        auto classDecl = dyn_cast<ClassDeclaration>(found);
         if (!classDecl) {
           error("name '" + name+ "' is not a user defined type like a class", location);
           return nullptr;
         }
-        return make_unique<ClassType>(classDecl);
+        return types->getClassType(classDecl);
+      }
+    }
+
+
+    /**
+     * Find a name in the current scopes and record it when it is a global name.
+     * @return the found node, nullptr if not found
+     */
+    ASTNode *findName(const Symbol &name) {
+      ASTNode *node = namesStack.findName(name);
+      // a missing name is also recorded, a global declaration with this name may be added later
+      if (!node || node->parentAstNode == root) {
+        useGlobalName(name);
+      }
+      return node;
+    }
+
+    void useGlobalName(const Symbol &name) {
+      if (usedGlobalNames) {
+        usedGlobalNames->push_back(name);
       }
     }
 
@@ -872,7 +1091,7 @@ class AstDecorator {
      * Adds a name to the provided scope and prints an error message when name already exists
      * @return true if name not already exists
      */
-    bool addNameToScope(NamesScope &scope, string name, ASTNode &node) {
+    bool addNameToScope(NamesScope &scope, const Symbol &name, ASTNode &node) {
       if (!scope.addName(name, node)) {
         error("name '" + name + "' already declared", node.location)
             .printMessage("name '" + name + "' previously declared here", scope.findName(name)->location);
@@ -883,8 +1102,8 @@ class AstDecorator {
 
 
     template <class T>
-    T findNameAs(string name) {
-      auto node = namesStack.findName(std::move(name));
+    T findNameAs(const Symbol &name) {
+      auto node = namesStack.findName(name);
       if (!node) {
 
       }
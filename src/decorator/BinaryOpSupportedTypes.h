@@ -4,10 +4,11 @@
  * Computes the result type of a binary operation
  * @param operandsType the type of both operands
  * @param operation
+ * @param types the result type is one of these types
  * @return InvalidType if operandsType does not support binary op,
  *          otherwise type of binary operation result
  */
-static unique_ptr<LangType> binaryOperationResultType(LangType *operandsType, BinaryExpressionOp operation) {
+static LangType *binaryOperationResultType(LangType *operandsType, BinaryExpressionOp operation, TypeContext &types) {
   if (operandsType->isNumericalType()) {
     // number
     switch (operation) {
@@ -17,30 +18,30 @@ static unique_ptr<LangType> binaryOperationResultType(LangType *operandsType, Bi
       case EXPR_OP_LESS_EQUALS_THEN:
       case EXPR_OP_EQUALS:
       case EXPR_OP_NOT_EQUALS:
-        return make_unique<BuildInType>(BuildIn_bool);
+        return types.getBuildInType(BuildIn_bool);
       case Expr_Op_Plus:
       case Expr_Op_Minus:
       case Expr_Op_Divide:
       case Expr_Op_Multiply:
-        return operandsType->clone();
+        return operandsType;
       default:
-        return make_unique<InvalidType>();
+        return types.getInvalidType();
     }
   }
-  else if (auto ty = dynamic_cast<BuildInType*>(operandsType)) {
+  else if (auto ty = dyn_cast_or_null<BuildInType>(operandsType)) {
     // bool
     if (ty->type == BuildIn_bool) {
       switch (operation) {
         case EXPR_OP_LOGIC_OR:
         case EXPR_OP_LOGIC_AND:
-          return make_unique<BuildInType>(BuildIn_bool);
+          return types.getBuildInType(BuildIn_bool);
         case EXPR_OP_EQUALS:
         case EXPR_OP_NOT_EQUALS:
         default:
-          return make_unique<InvalidType>();
+          return types.getInvalidType();
       }
     }
   }
 
-  return make_unique<InvalidType>();
+  return types.getInvalidType();
 }
\ No newline at end of file
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include "../parser/AST.h"
+
+using namespace std;
+
+
+
+/**
+ * Folds expressions of a decorated ast whose operands are const values into a single const value
+ * and replaces variables of local constants, that are never reassigned, with their value.
+ * Folding computes the same values as the generated code: i32 wraps around on overflow, f32 uses single precision
+ * and compares of f32 are ordered (false when a operand is NaN).
+ * Division of i32 by zero and of the smallest i32 by -1 is undefined and not folded.
+ */
+class ConstantFolder {
+  public:
+    /**
+     * @param arena new const values are created in this arena
+     */
+    explicit ConstantFolder(AstArena &arena) : arena(arena)
+    {}
+
+    /**
+     * Fold the body of a function that is decorated without errors.
+     */
+    void foldFunctionBody(FunctionDeclaration *func) {
+      if (!func->body) {
+        return;
+      }
+      localVariables.clear();
+      assignedVariables.clear();
+      collectVariables(func->body);
+      fold(func->body);
+    }
+
+    /**
+     * Fold a expression that is decorated without errors.
+     * @return the const value that replaced the expression or the expression itself when it could not be folded
+     */
+    Expression *foldExpression(Expression *expression) {
+      return cast<Expression>(fold(expression));
+    }
+
+
+  private:
+    AstArena &arena;
+    /** variables declared in the body of the current function */
+    unordered_map<AbstractVariableDeclaration*, VariableDeclaration*> localVariables;
+    /** variables that are target of a assignment in the current function */
+    unordered_set<AbstractVariableDeclaration*> assignedVariables;
+
+
+    void collectVariables(ASTNode *node) {
+      if (auto varDecl = dyn_cast<VariableDeclaration>(node)) {
+        localVariables[varDecl] = varDecl;
+      }
+      else if (auto assign = dyn_cast<VariableAssignStatement>(node)) {
+        assignedVariables.insert(assign->variableExpression->variableDeclaration);
+      }
+      for (auto child : node->getChildNodes()) {
+        collectVariables(child);
+      }
+    }
+
+    /**
+     * Fold the children of the node first, then the node itself.
+     * @return the node that replaced the given node or the node itself
+     */
+    ASTNode *fold(ASTNode *node) {
+      for (auto child : node->getChildNodes()) {
+        fold(child);
+      }
+
+      ConstValueExpression *value = nullptr;
+      switch (node->kind) {
+        case Node_UnaryExpression:
+          value = foldUnary(cast<UnaryExpression>(node));
+          break;
+        case Node_BinaryExpression:
+          value = foldBinary(cast<BinaryExpression>(node));
+          break;
+        case Node_VariableExpression:
+          value = propagateVariable(cast<VariableExpression>(node));
+          break;
+        default:
+          break;
+      }
+      return value ? replace(cast<Expression>(node), value) : node;
+    }
+
+    /**
+     * Replace the expression with the value, when the expression is not linked by its parent it stays.
+     */
+    Expression *replace(Expression *expression, ConstValueExpression *value) {
+      // only expressions linked as Expression or Statement can hold a const value
+      if (!expression->self1 && !expression->self2) {
+        return expression;
+      }
+      value->location = expression->location;
+      value->resultType = expression->resultType;
+      value->parentAstNode = expression->parentAstNode;
+      return expression->replaceNode(value);
+    }
+
+
+    ConstValueExpression *foldUnary(UnaryExpression *ex) {
+      auto inner = dyn_cast<BoolExpression>(ex->innerExpression);
+      if (ex->operation != Expr_Unary_Op_LOGIC_NOT || !inner) {
+        return nullptr;
+      }
+      return arena.make<BoolExpression>(!inner->value);
+    }
+
+    ConstValueExpression *foldBinary(BinaryExpression *ex) {
+      if (ex->lhs->kind != ex->rhs->kind) {
+        return nullptr;
+      }
+      switch (ex->lhs->kind) {
+        case Node_NumberIntExpression:
+          return foldInt(ex->operation, cast<NumberIntExpression>(ex->lhs)->value, cast<NumberIntExpression>(ex->rhs)->value);
+        case Node_NumberFloatExpression:
+          return foldFloat(ex->operation, cast<NumberFloatExpression>(ex->lhs)->value, cast<NumberFloatExpression>(ex->rhs)->value);
+        case Node_BoolExpression:
+          return foldBool(ex->operation, cast<BoolExpression>(ex->lhs)->value, cast<BoolExpression>(ex->rhs)->value);
+        default:
+          return nullptr;
+      }
+    }
+
+    ConstValueExpression *foldInt(BinaryExpressionOp op, int32_t lhs, int32_t rhs) {
+      // compute with unsigned values to wrap around on overflow like the generated code
+      auto ulhs = static_cast<uint32_t>(lhs);
+      auto urhs = static_cast<uint32_t>(rhs);
+      switch (op) {
+        case Expr_Op_Plus:
+          return makeInt(static_cast<int32_t>(ulhs + urhs));
+        case Expr_Op_Minus:
+          return makeInt(static_cast<int32_t>(ulhs - urhs));
+        case Expr_Op_Multiply:
+          return makeInt(static_cast<int32_t>(ulhs * urhs));
+        case Expr_Op_Divide:
+          if (rhs == 0 || (lhs == numeric_limits<int32_t>::min() && rhs == -1)) {
+            return nullptr;
+          }
+          return makeInt(lhs / rhs);
+        default:
+          return foldCompare(op, lhs, rhs);
+      }
+    }
+
+    ConstValueExpression *foldFloat(BinaryExpressionOp op, float lhs, float rhs) {
+      switch (op) {
+        case Expr_Op_Plus:
+          return makeFloat(lhs + rhs);
+        case Expr_Op_Minus:
+          return makeFloat(lhs - rhs);
+        case Expr_Op_Multiply:
+          return makeFloat(lhs * rhs);
+        case Expr_Op_Divide:
+          return makeFloat(lhs / rhs);
+        default:
+          return foldCompare(op, lhs, rhs);
+      }
+    }
+
+    ConstValueExpression *foldBool(BinaryExpressionOp op, bool lhs, bool rhs) {
+      switch (op) {
+        case EXPR_OP_LOGIC_AND:
+          return arena.make<BoolExpression>(lhs && rhs);
+        case EXPR_OP_LOGIC_OR:
+          return arena.make<BoolExpression>(lhs || rhs);
+        default:
+          return nullptr;
+      }
+    }
+
+    /**
+     * Compare like the signed integer and ordered float predicates of the generated code.
+     */
+    template<class V>
+    ConstValueExpression *foldCompare(BinaryExpressionOp op, V lhs, V rhs) {
+      switch (op) {
+        case EXPR_OP_EQUALS:
+          return arena.make<BoolExpression>(lhs == rhs);
+        case EXPR_OP_NOT_EQUALS:
+          return arena.make<BoolExpression>(lhs < rhs || lhs > rhs);
+        case EXPR_OP_GREATER_THEN:
+          return arena.make<BoolExpression>(lhs > rhs);
+        case EXPR_OP_GREATER_EQUALS_THEN:
+          return arena.make<BoolExpression>(lhs >= rhs);
+        case EXPR_OP_LESS_THEN:
+          return arena.make<BoolExpression>(lhs < rhs);
+        case EXPR_OP_LESS_EQUALS_THEN:
+          return arena.make<BoolExpression>(lhs <= rhs);
+        default:
+          return nullptr;
+      }
+    }
+
+    /**
+     * A local variable that is never reassigned and initialized with a number or bool is replaced by its value.
+     * The init expression is folded already since the declaration is before its usages.
+     */
+    ConstValueExpression *propagateVariable(VariableExpression *ex) {
+      auto local = localVariables.find(ex->variableDeclaration);
+      if (local == localVariables.end() || assignedVariables.count(ex->variableDeclaration)) {
+        return nullptr;
+      }
+      auto init = local->second->initExpression;
+      if (!init || !(isa<NumberExpression>(init) || isa<BoolExpression>(init))) {
+        return nullptr;
+      }
+      return cast<ConstValueExpression>(init)->clone(arena);
+    }
+
+    ConstValueExpression *makeInt(int32_t value) {
+      auto number = arena.make<NumberIntExpression>();
+      number->value = value;
+      return number;
+    }
+
+    ConstValueExpression *makeFloat(float value) {
+      auto number = arena.make<NumberFloatExpression>();
+      number->value = value;
+      return number;
+    }
+};
@@ -0,0 +1,438 @@
+#pragma once
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include "AstDecorator.h"
+#include "../parser/IncrementalParser.h"
+
+using namespace std;
+
+
+/**
+ * Keeps the decoration of the ast of an IncrementalParser up to date while its text is edited (e.g. in a watch mode).
+ * For each global declaration the global names it resolved are recorded,
+ * an update only decorates the declarations again that are new, have been edited or use a name whose declaration changed.
+ *
+ * Decorating changes the nodes of a declaration, thus a declaration is decorated again from undecorated nodes parsed from its text.
+ * When the resolved signature of the new nodes (types of the function, members or variable) equals the one of the existing declaration,
+ * the new bodies and init expressions are moved into the existing declaration, thus other declarations that link to it stay valid.
+ * Otherwise the new nodes replace the existing declaration and all declarations that use its name are decorated again.
+ */
+class IncrementalDecorator
+{
+  public:
+    explicit IncrementalDecorator(IncrementalParser &parser) : parser(parser)
+    {}
+
+    /**
+     * Decorate the changes of the ast since the last update, the first update decorates the whole ast.
+     * The messages of all declarations are printed again, grouped by declaration.
+     * @return true if there are no errors in the whole ast
+     */
+    bool update() {
+      RootDeclarations &root = parser.getRoot();
+      // after parsing the whole text again all nodes are new
+      if (parser.getFullParsesCount() != fullParsesCount) {
+        states.clear();
+        fullParsesCount = parser.getFullParsesCount();
+      }
+
+      vector<Redecoration> redecorations;
+      unordered_set<Symbol> changedNames;
+      addEditedRedecorations(root, redecorations, changedNames);
+      bool firstRound = true;
+
+      // signatures, repeated when the signature of an existing declaration changed
+      AstDecorator decorator;
+      while (true) {
+        addDependentRedecorations(changedNames, firstRound, redecorations);
+        firstRound = false;
+
+        decorator = AstDecorator();
+        decorator.useRoot(root);
+        ostringstream messages;
+        {
+          MessagesRedirect redirect(messages);
+          decorator.addGlobalNames(root);
+        }
+        globalMessages = messages.str();
+        globalErrors = decorator.errors;
+
+        unordered_map<ASTNode*, ASTNode*> replacements;
+        for (auto &redecoration : redecorations) {
+          redecoration.state = DeclarationState();
+          decorate(decorator, redecoration.state, [&]() {
+            doSignature(decorator, redecoration.node);
+          });
+          if (redecoration.existing && !sameSignature(redecoration.node, redecoration.existing)) {
+            replacements[redecoration.existing] = redecoration.node;
+            changedNames.insert(getName(redecoration.node));
+            redecoration.existing = nullptr;
+          }
+        }
+        if (replacements.empty()) {
+          break;
+        }
+        parser.replaceDeclarations(replacements);
+      }
+
+      // bodies
+      for (auto &redecoration : redecorations) {
+        ASTNode *node = redecoration.node;
+        if (redecoration.existing) {
+          adopt(redecoration.node, redecoration.existing);
+          node = redecoration.existing;
+        }
+        DeclarationState &state = redecoration.state;
+        decorate(decorator, state, [&]() {
+          if (auto classDecl = dyn_cast<ClassDeclaration>(node)) {
+            decorator.doClassDeclarationBody(classDecl);
+          }
+          else if (auto func = dyn_cast<FunctionDeclaration>(node)) {
+            state.isMain = decorator.doFunctionDeclarationBody(func);
+          }
+        });
+        sort(state.usedGlobalNames.begin(), state.usedGlobalNames.end(), [](const Symbol &a, const Symbol &b) {
+          return a.hash() < b.hash();
+        });
+        state.usedGlobalNames.erase(unique(state.usedGlobalNames.begin(), state.usedGlobalNames.end()), state.usedGlobalNames.end());
+        states[node] = move(state);
+      }
+      decoratedCount = redecorations.size();
+
+      return printMessages(root);
+    }
+
+    /**
+     * Amount of global declarations that have been decorated by the last update.
+     */
+    size_t getDecoratedCount() const {
+      return decoratedCount;
+    }
+
+  private:
+    struct DeclarationState {
+        /** names resolved in the global scope, also names that were not found */
+        vector<Symbol> usedGlobalNames;
+        string messages;
+        int errors = 0;
+        bool isMain = false;
+    };
+
+    /**
+     * Global declaration that is decorated again.
+     */
+    struct Redecoration {
+        /** undecorated nodes of the declaration */
+        ASTNode *node;
+        /** declaration that is kept when node has the same signature, null for new declarations */
+        ASTNode *existing;
+        /** result of decorating node */
+        DeclarationState state = {};
+    };
+
+    IncrementalParser &parser;
+    /** decorated global declarations of the ast */
+    unordered_map<ASTNode*, DeclarationState> states;
+    size_t fullParsesCount = 0;
+    string globalMessages;
+    int globalErrors = 0;
+    size_t decoratedCount = 0;
+
+
+    /**
+     * Add the declarations that are not decorated yet, these are new or have been parsed again after an edit.
+     * Each is matched with a removed declaration of the same kind and name, which is its existing declaration.
+     * The names of new and removed declarations without match are changed.
+     */
+    void addEditedRedecorations(RootDeclarations &root, vector<Redecoration> &redecorations, unordered_set<Symbol> &changedNames) {
+      vector<ASTNode*> declarations = getDeclarations(root);
+      unordered_set<ASTNode*> current(declarations.begin(), declarations.end());
+      unordered_multimap<Symbol, ASTNode*> removed;
+      for (auto it = states.begin(); it != states.end();) {
+        if (!current.count(it->first)) {
+          removed.emplace(getName(it->first), it->first);
+          it = states.erase(it);
+        }
+        else {
+          it++;
+        }
+      }
+
+      unordered_map<ASTNode*, ASTNode*> replacements;
+      for (auto node : declarations) {
+        if (states.count(node)) {
+          continue;
+        }
+        ASTNode *existing = nullptr;
+        auto range = removed.equal_range(getName(node));
+        for (auto it = range.first; it != range.second; it++) {
+          if (it->second->kind == node->kind) {
+            existing = it->second;
+            removed.erase(it);
+            break;
+          }
+        }
+        if (existing) {
+          // other declarations resolve the existing declaration until its signature differs
+          replacements[node] = existing;
+        }
+        else {
+          changedNames.insert(getName(node));
+        }
+        redecorations.push_back({node, existing});
+      }
+      for (auto &[name, node] : removed) {
+        changedNames.insert(name);
+      }
+      parser.replaceDeclarations(replacements);
+    }
+
+    /**
+     * Add the decorated declarations that use a changed name.
+     * In the first round also the declarations with messages are added, thus the locations in their messages are up to date.
+     */
+    void addDependentRedecorations(const unordered_set<Symbol> &changedNames, bool firstRound, vector<Redecoration> &redecorations) {
+      vector<ASTNode*> dependents;
+      for (auto it = states.begin(); it != states.end();) {
+        auto &usedNames = it->second.usedGlobalNames;
+        bool usesChangedName = any_of(usedNames.begin(), usedNames.end(), [&](const Symbol &name) {
+          return changedNames.count(name) > 0;
+        });
+        if (usesChangedName || (firstRound && !it->second.messages.empty())) {
+          dependents.push_back(it->first);
+          it = states.erase(it);
+        }
+        else {
+          it++;
+        }
+      }
+
+      // the text of dependents did not change, parse it again for undecorated nodes
+      vector<ASTNode*> reparsed = parser.reparseDeclarations(dependents);
+      for (size_t i = 0; i < dependents.size(); i++) {
+        redecorations.push_back({reparsed[i], dependents[i]});
+      }
+    }
+
+    /**
+     * Run the decoration step, its recorded names, messages and errors are added to the state.
+     */
+    template<class STEP>
+    static void decorate(AstDecorator &decorator, DeclarationState &state, const STEP &step) {
+      ostringstream messages;
+      int errorsBefore = decorator.errors;
+      decorator.usedGlobalNames = &state.usedGlobalNames;
+      {
+        MessagesRedirect redirect(messages);
+        step();
+      }
+      decorator.usedGlobalNames = nullptr;
+      state.messages += messages.str();
+      state.errors += decorator.errors - errorsBefore;
+    }
+
+    static void doSignature(AstDecorator &decorator, ASTNode *node) {
+      if (auto classDecl = dyn_cast<ClassDeclaration>(node)) {
+        decorator.doClassDeclarationSignature(classDecl);
+      }
+      else if (auto func = dyn_cast<FunctionDeclaration>(node)) {
+        decorator.doFunctionDeclarationSignature(func);
+      }
+      else {
+        decorator.doVariableDeclaration(cast<VariableDeclaration>(node), true);
+      }
+    }
+
+    /**
+     * Print the messages of all declarations and check for the main function.
+     * @return true if there are no errors
+     */
+    bool printMessages(RootDeclarations &root) {
+      int errors = globalErrors;
+      *messagesStream << globalMessages;
+      root.mainFunction = nullptr;
+      for (auto node : getDeclarations(root)) {
+        DeclarationState &state = states.at(node);
+        *messagesStream << state.messages;
+        errors += state.errors;
+        if (state.isMain) {
+          root.mainFunction = cast<FunctionDeclaration>(node);
+        }
+      }
+
+      // if no main
+      if (!root.mainFunction) {
+        ::error("no main function has been provided, the main function needs the signature 'func main(): i32'");
+        errors++;
+      }
+      return errors == 0;
+    }
+
+
+    /**
+     * All global declarations, the order of the messages.
+     */
+    static vector<ASTNode*> getDeclarations(RootDeclarations &root) {
+      vector<ASTNode*> declarations;
+      declarations.reserve(root.classDeclarations.size() + root.variableDeclarations.size() + root.functionDeclarations.size());
+      declarations.insert(declarations.end(), root.classDeclarations.begin(), root.classDeclarations.end());
+      declarations.insert(declarations.end(), root.variableDeclarations.begin(), root.variableDeclarations.end());
+      declarations.insert(declarations.end(), root.functionDeclarations.begin(), root.functionDeclarations.end());
+      return declarations;
+    }
+
+    static Symbol getName(ASTNode *declaration) {
+      if (auto classDecl = dyn_cast<ClassDeclaration>(declaration)) {
+        return classDecl->name;
+      }
+      if (auto func = dyn_cast<FunctionDeclaration>(declaration)) {
+        return func->name;
+      }
+      return cast<VariableDeclaration>(declaration)->name;
+    }
+
+
+    /*************************************************************************
+     **** Signatures *********************************************************
+     */
+
+    static bool sameSignature(ASTNode *a, ASTNode *b) {
+      if (a->kind != b->kind) {
+        return false;
+      }
+      if (auto classA = dyn_cast<ClassDeclaration>(a)) {
+        return sameClassSignature(classA, cast<ClassDeclaration>(b));
+      }
+      if (auto funcA = dyn_cast<FunctionDeclaration>(a)) {
+        return sameFunctionSignature(funcA, cast<FunctionDeclaration>(b));
+      }
+      return sameVariableSignature(cast<VariableDeclaration>(a), cast<VariableDeclaration>(b));
+    }
+
+    static bool sameClassSignature(ClassDeclaration *a, ClassDeclaration *b) {
+      if (a->name != b->name
+          || a->variableDeclarations.size() != b->variableDeclarations.size()
+          || a->functionDeclarations.size() != b->functionDeclarations.size()) {
+        return false;
+      }
+      for (size_t i = 0; i < a->variableDeclarations.size(); i++) {
+        if (!sameVariableSignature(a->variableDeclarations[i], b->variableDeclarations[i])) {
+          return false;
+        }
+      }
+      for (size_t i = 0; i < a->functionDeclarations.size(); i++) {
+        if (!sameFunctionSignature(a->functionDeclarations[i], b->functionDeclarations[i])) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    static bool sameFunctionSignature(FunctionDeclaration *a, FunctionDeclaration *b) {
+      if (a->name != b->name
+          || a->isExtern != b->isExtern
+          || a->returnType != b->returnType
+          || a->arguments.size() != b->arguments.size()) {
+        return false;
+      }
+      for (size_t i = 0; i < a->arguments.size(); i++) {
+        auto &argA = a->arguments[i];
+        auto &argB = b->arguments[i];
+        if (argA.name != argB.name
+            || argA.type != argB.type
+            || argA.isMutable != argB.isMutable
+            || !sameConstValue(argA.defaultExpression, argB.defaultExpression)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    static bool sameVariableSignature(VariableDeclaration *a, VariableDeclaration *b) {
+      return a->name == b->name
+          && a->type == b->type
+          && a->isMutable == b->isMutable
+          && sameConstValue(a->initExpression, b->initExpression);
+    }
+
+    /**
+     * @return true if both are missing or both are the same const value,
+     *         other expressions are never the same
+     */
+    static bool sameConstValue(Expression *a, Expression *b) {
+      if (!a || !b) {
+        return a == b;
+      }
+      if (a->kind != b->kind) {
+        return false;
+      }
+      switch (a->kind) {
+        case Node_NumberIntExpression:
+          return cast<NumberIntExpression>(a)->value == cast<NumberIntExpression>(b)->value;
+        case Node_NumberFloatExpression:
+          return cast<NumberFloatExpression>(a)->value == cast<NumberFloatExpression>(b)->value;
+        case Node_BoolExpression:
+          return cast<BoolExpression>(a)->value == cast<BoolExpression>(b)->value;
+        case Node_StringExpression:
+          return cast<StringExpression>(a)->value == cast<StringExpression>(b)->value;
+        default:
+          return false;
+      }
+    }
+
+
+    /*************************************************************************
+     **** Adopt **************************************************************
+     */
+
+    /**
+     * Move the locations, bodies and init expressions of the new nodes into the existing declaration with the same signature.
+     */
+    static void adopt(ASTNode *node, ASTNode *existing) {
+      if (auto classDecl = dyn_cast<ClassDeclaration>(node)) {
+        adoptClass(classDecl, cast<ClassDeclaration>(existing));
+      }
+      else if (auto func = dyn_cast<FunctionDeclaration>(node)) {
+        adoptFunction(func, cast<FunctionDeclaration>(existing));
+      }
+      else {
+        adoptVariable(cast<VariableDeclaration>(node), cast<VariableDeclaration>(existing));
+      }
+    }
+
+    static void adoptClass(ClassDeclaration *from, ClassDeclaration *to) {
+      to->location = from->location;
+      if (to->thisVarDecl) {
+        to->thisVarDecl->location = to->location;
+      }
+      for (size_t i = 0; i < to->variableDeclarations.size(); i++) {
+        adoptVariable(from->variableDeclarations[i], to->variableDeclarations[i]);
+      }
+      for (size_t i = 0; i < to->functionDeclarations.size(); i++) {
+        adoptFunction(from->functionDeclarations[i], to->functionDeclarations[i]);
+      }
+    }
+
+    static void adoptFunction(FunctionDeclaration *from, FunctionDeclaration *to) {
+      to->location = from->location;
+      for (size_t i = 0; i < to->arguments.size(); i++) {
+        auto &arg = to->arguments[i];
+        arg.location = from->arguments[i].location;
+        arg.defaultExpression = from->arguments[i].defaultExpression;
+        linkChild(&arg, arg.defaultExpression);
+      }
+      to->body = from->body;
+      linkChild(to, to->body);
+    }
+
+    static void adoptVariable(VariableDeclaration *from, VariableDeclaration *to) {
+      to->location = from->location;
+      to->initExpression = from->initExpression;
+      linkChild(to, to->initExpression);
+    }
+};
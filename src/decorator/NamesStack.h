@@ -1,56 +1,82 @@
 #pragma once
 
-#include <stack>
-#include <map>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include "util/Symbol.h"
 #include <utility>
 using namespace std;
 
-class AstLink {
-  public:
-    ASTNode *node;
-};
+class ASTNode;
+class NamesStack;
+
+
+/**
+ * Handle of a scope in the NamesStack.
+ * Names can only be added to the innermost scope of the stack.
+ */
 class NamesScope {
   public:
     /**
      * insert new name
-     * @return true when insert successful and false when name already exists
+     * @return true when insert successful and false when name already exists in this scope
      */
-    bool addName(const string& name, ASTNode &node) {
-      if (findName(name) == nullptr) {
-        namesMap.insert({name, AstLink{&node}});
-        return true;
-      }
-      else {
-        return false;
-      }
-    }
+    bool addName(const Symbol &name, ASTNode &node);
 
-    ASTNode * findName(string name) {
-      auto it = namesMap.find(name);
-      if (it != namesMap.end()) {
-        return it->second.node;
-      }
-      else {
-        return nullptr;
-      }
-    }
+    /**
+     * Find a name only in this scope.
+     * @return the found node, nullptr if not found
+     */
+    ASTNode * findName(const Symbol &name);
 
   private:
-    map<string, AstLink> namesMap;
+    NamesStack *stack;
+    /** amount of outer scopes */
+    uint32_t depth;
+    /** index of the first name of this scope in the names of the stack */
+    uint32_t begin;
+
+    friend class NamesStack;
+    NamesScope(NamesStack *stack, uint32_t depth, uint32_t begin) : stack(stack), depth(depth), begin(begin)
+    {}
 };
 
+
+/**
+ * Names of all scopes in one flat stack.
+ * A scope is a range of the stack, removing the innermost scope pops all names down to its begin.
+ * A open addressing hash table maps each symbol to its innermost name in the stack,
+ * each name links to the name it shadows, thus popping a name restores the shadowed one.
+ */
 class NamesStack {
   public:
-    NamesScope& addNamesScope() {
-      return scopes.emplace_back(NamesScope());
+    /**
+     * @param outerNames names that are found when a name is not in this stack (e.g. the global names),
+     *                   they must not change while this stack exists, then multiple threads can share them
+     */
+    explicit NamesStack(const NamesStack *outerNames = nullptr) : outerNames(outerNames) {
+      table.resize(MIN_TABLE_SIZE);
     }
 
+    NamesScope addNamesScope() {
+      scopeBegins.push_back(names.size());
+      return NamesScope(this, scopeBegins.size() - 1, names.size());
+    }
+
+    /**
+     * Remove the innermost scope and all its names.
+     */
     void removeNamesScope(const NamesScope& scope) {
-      auto it = find_if(scopes.begin(), scopes.end(), [&](const NamesScope& other) {return &other == &scope;});
-      if (it == scopes.end()) {
-        throw runtime_error("while decorating: tried to remove a NamesScope that did not exist");
+      if (scope.stack != this || !isInnermost(scope)) {
+        throw runtime_error("while decorating: tried to remove a NamesScope that did not exist or is not the innermost scope");
       }
-      scopes.erase(it);
+      while (names.size() > scope.begin) {
+        Name &name = names.back();
+        findSlot(name.name).name = name.shadowed;
+        names.pop_back();
+      }
+      scopeBegins.pop_back();
     }
 
     /**
@@ -58,16 +84,134 @@ class NamesStack {
      * @param name
      * @return the found node, nullptr if not found
      */
-    ASTNode * findName(string name) {
-      for (auto it = scopes.rbegin(); it != scopes.rend(); it++) {
-        ASTNode * node = it->findName(name);
-        if (node != nullptr) {
-          return node;
-        }
+    ASTNode * findName(const Symbol &name) const {
+      uint32_t index = findInnermost(name);
+      if (index != NO_NAME) {
+        return names[index].node;
       }
-      return nullptr;
+      return outerNames ? outerNames->findName(name) : nullptr;
     }
 
   private:
-    list<NamesScope> scopes;
-};
\ No newline at end of file
+    static constexpr uint32_t NO_NAME = UINT32_MAX;
+    static constexpr size_t MIN_TABLE_SIZE = 64;
+
+    struct Name {
+        ASTNode *node;
+        Symbol name;
+        /** index of the name with the same symbol in an outer scope */
+        uint32_t shadowed;
+    };
+
+    /**
+     * Entry of the hash table, symbols are never removed from the table,
+     * a symbol without name in any scope has NO_NAME.
+     */
+    struct Slot {
+        Symbol symbol;
+        /** index of the innermost name of the symbol */
+        uint32_t name = NO_NAME;
+    };
+
+    vector<Name> names;
+    vector<uint32_t> scopeBegins;
+    /** size is a power of two, the empty symbol marks a free slot */
+    vector<Slot> table;
+    size_t usedSlots = 0;
+    const NamesStack *outerNames;
+
+    friend class NamesScope;
+
+
+    bool isInnermost(const NamesScope &scope) {
+      return scope.depth + 1 == scopeBegins.size();
+    }
+
+    /**
+     * @return innermost name of the symbol or NO_NAME
+     */
+    uint32_t findInnermost(const Symbol &symbol) const {
+      return table[findSlotIndex(symbol)].name;
+    }
+
+    void pushName(const Symbol &symbol, ASTNode &node) {
+      Slot &slot = findSlot(symbol);
+      if (slot.symbol.empty()) {
+        slot.symbol = symbol;
+        usedSlots++;
+      }
+      names.push_back(Name{&node, symbol, slot.name});
+      slot.name = names.size() - 1;
+
+      // keep the load factor below 1/2
+      if (usedSlots * 2 > table.size()) {
+        rehash();
+      }
+    }
+
+    /**
+     * Find the slot of the symbol or the free slot where it has to be inserted.
+     */
+    Slot &findSlot(const Symbol &symbol) {
+      return table[findSlotIndex(symbol)];
+    }
+
+    size_t findSlotIndex(const Symbol &symbol) const {
+      size_t mask = table.size() - 1;
+      for (size_t i = hashSymbol(symbol) & mask;; i = (i + 1) & mask) {
+        const Slot &slot = table[i];
+        if (slot.symbol == symbol || slot.symbol.empty()) {
+          return i;
+        }
+      }
+    }
+
+    /**
+     * Symbols are hashed by the address of their text, mix it since the low bits of addresses are mostly zero.
+     */
+    static size_t hashSymbol(const Symbol &symbol) {
+      uint64_t hash = symbol.hash() * 0x9E3779B97F4A7C15ull;
+      return hash >> 32;
+    }
+
+    /**
+     * Rebuild the table, drops symbols that have no name anymore.
+     * The new size is at least four times the remaining symbols.
+     */
+    void rehash() {
+      size_t liveSlots = count_if(table.begin(), table.end(), [](const Slot &slot) {
+        return !slot.symbol.empty() && slot.name != NO_NAME;
+      });
+      size_t size = MIN_TABLE_SIZE;
+      while (size < liveSlots * 4) {
+        size *= 2;
+      }
+
+      vector<Slot> oldTable(size);
+      swap(table, oldTable);
+      usedSlots = 0;
+      for (auto &slot : oldTable) {
+        if (!slot.symbol.empty() && slot.name != NO_NAME) {
+          findSlot(slot.symbol) = slot;
+          usedSlots++;
+        }
+      }
+    }
+};
+
+
+inline bool NamesScope::addName(const Symbol &name, ASTNode &node) {
+  if (!stack->isInnermost(*this)) {
+    throw runtime_error("while decorating: tried to add a name to a NamesScope that is not the innermost scope");
+  }
+  if (findName(name) != nullptr) {
+    return false;
+  }
+  stack->pushName(name, node);
+  return true;
+}
+
+inline ASTNode * NamesScope::findName(const Symbol &name) {
+  uint32_t index = stack->findInnermost(name);
+  return index != NamesStack::NO_NAME && index >= begin ? stack->names[index].node : nullptr;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <vector>
+#include <unordered_set>
+#include "../parser/AST.h"
+
+using namespace std;
+
+
+
+/**
+ * Functions and classes of a decorated ast that are reachable from the main function.
+ * A function is reachable when a reachable function calls it,
+ * a class is reachable when reachable code uses its type or a member function of it is reachable.
+ * The classes of member variable types of a reachable class are reachable too, since they are part of its layout.
+ * Without a main function all declarations are reachable.
+ */
+class ReachableDeclarations {
+  public:
+    /**
+     * All declarations are reachable.
+     */
+    ReachableDeclarations() = default;
+
+    explicit ReachableDeclarations(RootDeclarations &root) {
+      if (!root.mainFunction) {
+        return;
+      }
+      allReachable = false;
+      addFunction(root.mainFunction);
+      while (!pendingFunctions.empty()) {
+        auto func = pendingFunctions.back();
+        pendingFunctions.pop_back();
+        if (func->body) {
+          addUsages(func->body);
+        }
+      }
+    }
+
+    bool contains(FunctionDeclaration *func) const {
+      return allReachable || functions.count(func);
+    }
+
+    bool contains(ClassDeclaration *classDecl) const {
+      return allReachable || classes.count(classDecl);
+    }
+
+
+  private:
+    bool allReachable = true;
+    unordered_set<FunctionDeclaration*> functions;
+    unordered_set<ClassDeclaration*> classes;
+    /** reachable functions whose body is not searched yet */
+    vector<FunctionDeclaration*> pendingFunctions;
+
+
+    void addFunction(FunctionDeclaration *func) {
+      if (!func || !functions.insert(func).second) {
+        return;
+      }
+      pendingFunctions.push_back(func);
+      addClass(func->parentClass);
+      addType(func->returnType);
+      for (auto &arg : func->arguments) {
+        addType(arg.type);
+      }
+    }
+
+    void addClass(ClassDeclaration *classDecl) {
+      if (!classDecl || !classes.insert(classDecl).second) {
+        return;
+      }
+      for (auto memberVar : classDecl->variableDeclarations) {
+        addType(memberVar->type);
+      }
+    }
+
+    void addType(LangType *type) {
+      if (auto classType = dyn_cast_or_null<ClassType>(type)) {
+        addClass(classType->classDeclaration);
+      }
+    }
+
+    /**
+     * Add the called functions and used class types of the node and its children.
+     */
+    void addUsages(ASTNode *node) {
+      if (auto call = dyn_cast<CallExpression>(node)) {
+        addFunction(call->functionDeclaration);
+      }
+      if (auto expression = dyn_cast<Expression>(node)) {
+        addType(expression->resultType);
+      }
+      else if (auto varDecl = dyn_cast<VariableDeclaration>(node)) {
+        addType(varDecl->type);
+      }
+      for (auto child : node->getChildNodes()) {
+        addUsages(child);
+      }
+    }
+};
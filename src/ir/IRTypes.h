@@ -61,18 +61,13 @@ class IRTypePointer {
 
 
 static IRType langTypeToIRType(LangType *langType) {
-  if (auto buildIn = dynamic_cast<BuildInType*>(langType)) {
+  if (auto buildIn = dyn_cast_or_null<BuildInType>(langType)) {
     return IRTypeBuildIn(buildIn->type);
   }
 
   return IRTypeInvalid();
 }
 
-static IRType langTypeToIRType(unique_ptr<LangType> &langType) {
-  return langTypeToIRType(langType.get());
-}
-
-
 static string irTypeToString(IRType &type) {
   if (std::holds_alternative<IRTypeBuildIn>(type)) {
     return buildInTypeToString(get<IRTypeBuildIn>(type).buildInType);
@@ -3,7 +3,7 @@
 #include "ir/builder/exceptions.h"
 
 static BuildInType *getBuildInTypeFor(LangType *type, SrcLocationRange location) {
-  auto typeBuildIn = dynamic_cast<BuildInType*>(type);
+  auto typeBuildIn = dyn_cast_or_null<BuildInType>(type);
   if (!typeBuildIn) {
     throw IRGenException("only buildIn types are currently supported", location);
   }
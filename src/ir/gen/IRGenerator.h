@@ -8,6 +8,7 @@
 #include "ir/visitor/IRVisitor.h"
 #include "ir/printer/IRPrinter.h"
 #include "ir/passes/IRRemoveBBRedundantTermPass.hpp"
+#include "decorator/ReachableDeclarations.h"
 
 
 struct IRGenFlags {
@@ -46,6 +47,7 @@ struct IRGenFlags {
 
     void generate(RootDeclarations &rootDecls, string srcFileName){
       builder.module->sourceFileName = move(srcFileName);
+      reachable = ReachableDeclarations(rootDecls);
       accept(&rootDecls, {});
 
       // cleanup instructions after termination instruction of a basic block
@@ -67,6 +69,8 @@ struct IRGenFlags {
     // TODO: clean workaround: pseudo function with entry bb for init values of global variables
     IRFunction globalVarInitValueHoldingFunc = IRFunction("globalVarInitValueHoldingFunc");
     IRBasicBlock *globalVarInitValueHoldingBB = nullptr;
+    /** ir is only generated for reachable functions and classes */
+    ReachableDeclarations reachable;
 
     /// ********************************************************************
     /// Declarations
@@ -76,22 +80,30 @@ struct IRGenFlags {
       // gen global symbols
       // gen global variables [only definition]
       for (auto &global : rootDecl->variableDeclarations) {
-        genGlobalVariableDefinition(global.get());
+        genGlobalVariableDefinition(global);
       }
 
       // gen function [only definition, no body]
-      for (auto &function : rootDecl->functionDeclarations) {
-        genFunctionDefinition(&function);
+      for (auto function : rootDecl->functionDeclarations) {
+        // lazy parsed function is not reachable from main
+        if (function->hasUnparsedBody() || !reachable.contains(function)) {
+          continue;
+        }
+        genFunctionDefinition(function);
       }
 
       for (auto &decl: rootDecl->classDeclarations) {
-        error("classes are not implemented yet in IR", decl->location);
+        if (reachable.contains(decl)) {
+          error("classes are not implemented yet in IR", decl->location);
+        }
       }
       for (auto &decl: rootDecl->variableDeclarations) {
-        visitGlobalVariableDecl(decl.get(), flags);
+        visitGlobalVariableDecl(decl, flags);
       }
-      for (auto &decl: rootDecl->functionDeclarations) {
-        accept(&decl, flags);
+      for (auto decl: rootDecl->functionDeclarations) {
+        if (!decl->hasUnparsedBody() && reachable.contains(decl)) {
+          accept(decl, flags);
+        }
       }
       return nullptr;
     }
@@ -101,8 +113,9 @@ struct IRGenFlags {
      * Generate global variable definition without init.
      */
     void genGlobalVariableDefinition(VariableDeclaration *varDecl) {
-      auto* ex = dynamic_cast<NumberExpression*>(varDecl->initExpression.get());
-      if (!ex) {
+      // the decorator folds constant init expressions into a single value
+      auto* ex = dyn_cast_or_null<ConstValueExpression>(varDecl->initExpression);
+      if (!ex || isa<StringExpression>(ex)) {
         printError("", "globals need to have a constant init expression -> global ignored", varDecl->location);
         return;
       }
@@ -112,11 +125,11 @@ struct IRGenFlags {
       }
 
       IRValueVar *valVar = nullptr;
-      if (auto type = dynamic_cast<BuildInType*>(varDecl->type.get())) {
-        IRGlobalVar &var = builder.GlobalVar(varDecl->name);
+      if (auto type = dyn_cast_or_null<BuildInType>(varDecl->type)) {
+        IRGlobalVar &var = builder.GlobalVar(varDecl->name.str());
         var.type = IRTypePointer(langTypeToIRType(type));
         var.initValue = nullptr; // will be set later
-        var.name = varDecl->name;
+        var.name = varDecl->name.str();
         valVar = (IRValueVar*)&var;
       }
       else {
@@ -130,7 +143,7 @@ struct IRGenFlags {
      * Generate function definition without body.
      */
     void genFunctionDefinition(FunctionDeclaration *funcDecl) {
-      IRFunction &function = builder.Function(funcDecl->name);
+      IRFunction &function = builder.Function(funcDecl->name.str());
       function.returnType = langTypeToIRType(funcDecl->returnType);
       function.isExtern = funcDecl->isExtern;
       funcDecl->irFunction = &function;
@@ -152,7 +165,7 @@ struct IRGenFlags {
     /// TODO: partially merge with visitVariableDecl
     void visitGlobalVariableDecl(VariableDeclaration *varDecl, IRGenFlags flags) {
       builder.setInsertionBasicBlock(*globalVarInitValueHoldingBB);
-      accept(varDecl->initExpression.get(), flags);
+      accept(varDecl->initExpression, flags);
       module.globalVariablesInitValues.push_back(globalVarInitValueHoldingBB->instructions.back());
       IRValueVar *initVal = &module.globalVariablesInitValues.back();
       globalVarInitValueHoldingBB->instructions.pop_back();
@@ -164,9 +177,9 @@ struct IRGenFlags {
 
     IRValueVar* visitVariableDecl(VariableDeclaration *varDecl, IRGenFlags flags) override {
       IRValueVar *valVar = nullptr;
-      if (auto type = dynamic_cast<BuildInType*>(varDecl->type.get())) {
+      if (auto type = dyn_cast_or_null<BuildInType>(varDecl->type)) {
         IRBuildInTypeAllocation &alloc = builder.Instruction(IRBuildInTypeAllocation(type->type));
-        alloc.name = varDecl->name;
+        alloc.name = varDecl->name.str();
         valVar = (IRValueVar*)&alloc;
       }
       else {
@@ -177,7 +190,7 @@ struct IRGenFlags {
         throw IRGenException("variables need an initial value", varDecl->location);
       }
 
-      IRValueVar *initVal = accept(varDecl->initExpression.get(), flags);
+      IRValueVar *initVal = accept(varDecl->initExpression, flags);
       builder.Instruction(IRStore(valVar, initVal));
       varDecl->irVariablePtr = valVar;
 
@@ -191,7 +204,7 @@ struct IRGenFlags {
       builder.setInsertionBasicBlock(*function->basicBlocks.begin());
 
       if (funcDecl->body) {
-        accept(funcDecl->body.get(), flags);
+        accept(funcDecl->body, flags);
       }
       return nullptr;
     }
@@ -199,14 +212,14 @@ struct IRGenFlags {
 
     IRValueVar* visitFunctionParamDeclaration(FunctionParamDeclaration *funcParam, IRGenFlags flags) override {
       IRValueVar *valVar = nullptr;
-      IRFunctionArgument &arg = builder.FunctionArgument(funcParam->name);
+      IRFunctionArgument &arg = builder.FunctionArgument(funcParam->name.str());
       arg.astFunctionParamDeclaration = funcParam;
       valVar = (IRValueVar *) &arg;
-      arg.name = funcParam->name;
+      arg.name = funcParam->name.str();
       // this needs to be updated again later genFunctionDefinition(...)
       funcParam->irVariablePtr = valVar;
 
-      if (auto type = dynamic_cast<BuildInType *>(funcParam->type.get())) {
+      if (auto type = dyn_cast_or_null<BuildInType>(funcParam->type)) {
         arg.type = IRTypePointer(langTypeToIRType(type));
         //arg.type = langTypeToIRType(type);
       }
@@ -221,7 +234,7 @@ struct IRGenFlags {
 
         // insert args default value expression into global dummy basic block
         builder.setInsertionBasicBlock(*globalVarInitValueHoldingBB);  // note: this also resets the current function
-        accept(funcParam->defaultExpression.get(), flags);
+        accept(funcParam->defaultExpression, flags);
         module.globalVariablesInitValues.push_back(globalVarInitValueHoldingBB->instructions.back());
         IRValueVar *initVal = &module.globalVariablesInitValues.back();
         globalVarInitValueHoldingBB->instructions.pop_back();
@@ -238,10 +251,10 @@ struct IRGenFlags {
     IRValueVar* visitClassDecl(ClassDeclaration *classDecl, IRGenFlags flags) override {
       throw IRGenInternalException("ir generation of classes currently not supported", classDecl->location);
       for (auto &e : classDecl->variableDeclarations) {
-        accept(e.get(), flags);
+        accept(e, flags);
       }
-      for (auto &e : classDecl->functionDeclarations) {
-        accept(&e, flags);
+      for (auto e : classDecl->functionDeclarations) {
+        accept(e, flags);
       }
     }
 
@@ -252,18 +265,18 @@ struct IRGenFlags {
 
     IRValueVar* visitCompoundStatement(CompoundStatement *st, IRGenFlags flags) override {
       for (auto &child : st->statements) {
-        accept(child.get(), flags);
+        accept(child, flags);
       }
       return nullptr;
     }
 
     IRValueVar* visitVariableAssignStatement(VariableAssignStatement *st, IRGenFlags flags) override {
-      auto type = st->variableExpression->resultType.get();
-      auto variablePtr = accept(st->variableExpression.get(), flags.withReturnPointerValue(true)); // @todo this needs to be a pointer, pass returnPointer argument to accept
-      auto value = accept(st->valueExpression.get(), flags);
+      auto type = st->variableExpression->resultType;
+      auto variablePtr = accept(st->variableExpression, flags.withReturnPointerValue(true)); // @todo this needs to be a pointer, pass returnPointer argument to accept
+      auto value = accept(st->valueExpression, flags);
 
       // if is class type -> copy
-      if (auto classType = dynamic_cast<ClassType*>(st->variableExpression->resultType.get())) {
+      if (auto classType = dyn_cast_or_null<ClassType>(st->variableExpression->resultType)) {
         throw IRGenException("class type currently can't be assigned", st->location);
       }
       // buildIn type
@@ -281,7 +294,7 @@ struct IRGenFlags {
     IRValueVar* visitReturnStatement(ReturnStatement *st, IRGenFlags flags) override {
       IRValueVar *returnValue = nullptr;
       if (st->expression) {
-        returnValue = accept(st->expression->get(), flags);
+        returnValue = accept(st->expression, flags);
       }
       return &(IRValueVar&) builder.Instruction(IRReturn(returnValue));
     }
@@ -290,13 +303,13 @@ struct IRGenFlags {
       AstCodePrinter astPrinter;
 
       builder.Instruction(IRValueComment("condition for if  \t\t" + astPrinter.getAstAsCode(*st->condition, true)));
-      IRValueVar *condition = accept(st->condition.get(), flags);
+      IRValueVar *condition = accept(st->condition, flags);
       IRConditionalJump &condJump = builder.Instruction(IRConditionalJump(condition)); // set jump bbs later
 
       IRBasicBlock *bbThen = &builder.BasicBlock("ifThen");
       IRBasicBlock *bbEndOfThen; // bb when execution of then is finished, this can but does not have to be bbThen
       condJump.jumpToWhenTrueBB = bbThen;
-      accept(st->ifBody.get(), flags);
+      accept(st->ifBody, flags);
       bbEndOfThen = &builder.getInsertionBasicBlock();
 
       IRBasicBlock *bbElse;
@@ -304,7 +317,7 @@ struct IRGenFlags {
       if (st->elseBody) {
         bbElse = &builder.BasicBlock("ifElse");
         condJump.jumpToWhenFalseBB = bbElse;
-        accept(st->elseBody.get(), flags);
+        accept(st->elseBody, flags);
         bbEndOfElse = &builder.getInsertionBasicBlock();
       }
 
@@ -336,10 +349,10 @@ struct IRGenFlags {
 
       auto &bbCond = builder.BasicBlock("whileCond");
       builder.Instruction(IRValueComment("condition for while  \t\t" + astPrinter.getAstAsCode(*st->condition, true)));
-      auto *cond = accept(st->condition.get(), flags);
+      auto *cond = accept(st->condition, flags);
 
       auto &bbBody = builder.BasicBlock("whileBody");
-      accept(st->body.get(), flags);
+      accept(st->body, flags);
       builder.Instruction(IRJump(&bbCond));
 
       auto &bbAfterWhile = builder.BasicBlock("afterWhile");
@@ -398,7 +411,7 @@ struct IRGenFlags {
     }
 
     IRValueVar* visitMemberVariableExpression(MemberVariableExpression *ex, IRGenFlags flags) override {
-      accept(ex->parent.get(), flags);
+      accept(ex->parent, flags);
       return nullptr;
     }
 
@@ -426,19 +439,19 @@ struct IRGenFlags {
     }
 
     IRValueVar* visitMemberCallExpression(MemberCallExpression *ex, IRGenFlags flags) override {
-      accept(ex->parent.get(), flags);
+      accept(ex->parent, flags);
       return visitCallExpression(ex, flags);
     }
 
     IRValueVar* visitCallExpressionArgument(CallExpressionArgument *ex, IRGenFlags flags) override {
-      return accept(ex->expression.get(), flags);
+      return accept(ex->expression, flags);
     }
 
 
     IRValueVar* visitUnaryExpression(UnaryExpression *ex, IRGenFlags flags) override {
       switch (ex->operation) {
         case Expr_Unary_Op_LOGIC_NOT: {
-          IRValueVar *toNegate = accept(ex->innerExpression.get(), flags);
+          IRValueVar *toNegate = accept(ex->innerExpression, flags);
           return &(IRValueVar&) builder.Instruction(IRLogicalNot(toNegate));
         }
         default:
@@ -448,14 +461,14 @@ struct IRGenFlags {
     }
 
     IRValueVar* visitBinaryExpression(BinaryExpression *ex, IRGenFlags flags) override {
-      auto resultType = dynamic_cast<BuildInType*>(ex->resultType.get());
-      auto operandType = dynamic_cast<BuildInType*>(ex->lhs->resultType.get());
+      auto resultType = dyn_cast_or_null<BuildInType>(ex->resultType);
+      auto operandType = dyn_cast_or_null<BuildInType>(ex->lhs->resultType);
       if (!resultType || !operandType) {
         throw IRGenException("only buildIn types are currently supported", ex->location);
       }
 
-      auto lVal = accept(ex->lhs.get(), flags);
-      auto rVal = accept(ex->rhs.get(), flags);
+      auto lVal = accept(ex->lhs, flags);
+      auto rVal = accept(ex->rhs, flags);
 
       // check value type and operation type
       // number calculation
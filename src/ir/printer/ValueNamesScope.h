@@ -2,6 +2,7 @@
 #include "ir/IRModule.h"
 #include "ir/IRValueVar.h"
 #include <set>
+#include <map>
 
 
 /**
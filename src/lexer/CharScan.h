@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+using namespace std;
+
+
+/**
+ * Helpers to scan runs of characters in the source text.
+ * When available SSE2 or AVX2 is used to test 16 or 32 chars at once,
+ * the remaining chars at the end of the text are tested one by one.
+ * All functions get the text, the index to start at and the text size
+ * and return the index of the first char that ends the run (or size).
+ */
+namespace charScan
+{
+  inline bool isSpace(char c)
+  {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+  }
+
+  inline bool isDigit(char c)
+  {
+    return c >= '0' && c <= '9';
+  }
+
+  inline bool isIdentifier(char c)
+  {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || isDigit(c) || c == '_';
+  }
+
+#if defined(__AVX2__)
+  constexpr size_t WIDTH = 32;
+  using Vec = __m256i;
+  inline Vec load(const char *p) { return _mm256_loadu_si256((const __m256i *) p); }
+  inline Vec eq(Vec v, char c) { return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)); }
+  inline Vec vor(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+  inline uint32_t mask(Vec v) { return (uint32_t) _mm256_movemask_epi8(v); }
+  /** chars in [lo, hi] (unsigned compare) */
+  inline Vec inRange(Vec v, char lo, char hi) {
+    Vec shifted = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8((char) (hi - lo))), shifted);
+  }
+#elif defined(__SSE2__)
+  constexpr size_t WIDTH = 16;
+  using Vec = __m128i;
+  inline Vec load(const char *p) { return _mm_loadu_si128((const __m128i *) p); }
+  inline Vec eq(Vec v, char c) { return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); }
+  inline Vec vor(Vec a, Vec b) { return _mm_or_si128(a, b); }
+  inline uint32_t mask(Vec v) { return (uint32_t) _mm_movemask_epi8(v); }
+  /** chars in [lo, hi] (unsigned compare) */
+  inline Vec inRange(Vec v, char lo, char hi) {
+    Vec shifted = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8((char) (hi - lo))), shifted);
+  }
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+  constexpr uint32_t FULL_MASK = WIDTH == 32 ? 0xFFFFFFFFu : 0xFFFFu;
+
+  /**
+   * Advance in blocks of WIDTH chars while all chars of a block match.
+   * @param matches returns the bit mask of matching chars of a block
+   * @return index of the first not matching char or the start of the last incomplete block
+   */
+  template<typename Matches>
+  inline size_t skipBlocks(const char *text, size_t index, size_t size, Matches matches)
+  {
+    while (index + WIDTH <= size) {
+      uint32_t notMatching = ~matches(load(text + index)) & FULL_MASK;
+      if (notMatching != 0) {
+        return index + __builtin_ctz(notMatching);
+      }
+      index += WIDTH;
+    }
+    return index;
+  }
+#endif
+
+
+  /**
+   * @return index of the first char that is not a space, tab, carriage return or new line
+   */
+  inline size_t skipSpaces(const char *text, size_t index, size_t size)
+  {
+#if defined(__AVX2__) || defined(__SSE2__)
+    index = skipBlocks(text, index, size, [](Vec v) {
+      return mask(vor(vor(eq(v, ' '), eq(v, '\n')), vor(eq(v, '\t'), eq(v, '\r'))));
+    });
+#endif
+    while (index < size && isSpace(text[index])) {
+      index++;
+    }
+    return index;
+  }
+
+  /**
+   * @return index of the first char that can't be part of a identifier
+   */
+  inline size_t skipIdentifierChars(const char *text, size_t index, size_t size)
+  {
+#if defined(__AVX2__) || defined(__SSE2__)
+    index = skipBlocks(text, index, size, [](Vec v) {
+      return mask(vor(vor(inRange(v, 'a', 'z'), inRange(v, 'A', 'Z')), vor(inRange(v, '0', '9'), eq(v, '_'))));
+    });
+#endif
+    while (index < size && isIdentifier(text[index])) {
+      index++;
+    }
+    return index;
+  }
+
+  /**
+   * @return index of the first char that is not a digit
+   */
+  inline size_t skipDigits(const char *text, size_t index, size_t size)
+  {
+#if defined(__AVX2__) || defined(__SSE2__)
+    index = skipBlocks(text, index, size, [](Vec v) {
+      return mask(inRange(v, '0', '9'));
+    });
+#endif
+    while (index < size && isDigit(text[index])) {
+      index++;
+    }
+    return index;
+  }
+
+  /**
+   * @return index of the first occurrence of c
+   */
+  inline size_t find(const char *text, size_t index, size_t size, char c)
+  {
+#if defined(__AVX2__) || defined(__SSE2__)
+    index = skipBlocks(text, index, size, [c](Vec v) {
+      return ~mask(eq(v, c));
+    });
+#endif
+    while (index < size && text[index] != c) {
+      index++;
+    }
+    return index;
+  }
+
+  /**
+   * @return index of the first occurrence of a or b
+   */
+  inline size_t findAny(const char *text, size_t index, size_t size, char a, char b)
+  {
+#if defined(__AVX2__) || defined(__SSE2__)
+    index = skipBlocks(text, index, size, [a, b](Vec v) {
+      return ~mask(vor(eq(v, a), eq(v, b)));
+    });
+#endif
+    while (index < size && text[index] != a && text[index] != b) {
+      index++;
+    }
+    return index;
+  }
+
+  /**
+   * @return index of the '*' of the first occurrence of "*\/"
+   */
+  inline size_t findMultiLineCommentEnd(const char *text, size_t index, size_t size)
+  {
+    for (index = find(text, index, size, '*'); index < size; index = find(text, index + 1, size, '*')) {
+      if (index + 1 < size && text[index + 1] == '/') {
+        return index;
+      }
+    }
+    return size;
+  }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include "Token.h"
+using namespace std;
+
+
+/**
+ * Keyword recognition via a perfect hash that is generated at compile time.
+ * To add a keyword just add it to the keywords list,
+ * a collision free hash seed for the table is searched by the compiler.
+ */
+namespace keywords
+{
+  struct Keyword
+  {
+    string_view name;
+    TOKEN_TYPE type;
+  };
+
+  constexpr Keyword keywords[] = {
+      {"let",    Keyword_let},
+      {"if",     Keyword_if},
+      {"while",  Keyword_while},
+      {"else",   Keyword_else},
+      {"true",   Keyword_true},
+      {"false",  Keyword_false},
+      {"fun",    Keyword_fun},
+      {"class",  Keyword_class},
+      {"extern", Keyword_extern},
+      {"return", Keyword_return},
+  };
+
+  // table has at least twice as much slots as there are keywords
+  constexpr uint32_t TABLE_BITS = [] {
+    uint32_t bits = 1;
+    while ((1u << bits) < size(keywords) * 2) {
+      bits++;
+    }
+    return bits;
+  }();
+  constexpr uint32_t TABLE_SIZE = 1u << TABLE_BITS;
+
+  /**
+   * Multiplicative hash over length, first and last char.
+   * @param text has to be not empty
+   */
+  constexpr uint32_t hash(string_view text, uint32_t seed)
+  {
+    uint32_t key = (uint32_t(uint8_t(text.front())) << 16) | (uint32_t(uint8_t(text.back())) << 8) | uint32_t(text.size() & 0xFF);
+    return (key * seed) >> (32 - TABLE_BITS);
+  }
+
+  constexpr bool isCollisionFree(uint32_t seed)
+  {
+    array<bool, TABLE_SIZE> used{};
+    for (const Keyword &keyword : keywords) {
+      uint32_t slot = hash(keyword.name, seed);
+      if (used[slot]) {
+        return false;
+      }
+      used[slot] = true;
+    }
+    return true;
+  }
+
+  /**
+   * @return the first odd seed without collisions, 0 if there is none
+   */
+  constexpr uint32_t findSeed()
+  {
+    for (uint32_t seed = 0x9E3779B1; seed < 0x9E3779B1 + 2 * 100000; seed += 2) {
+      if (isCollisionFree(seed)) {
+        return seed;
+      }
+    }
+    return 0;
+  }
+
+  constexpr uint32_t SEED = findSeed();
+  static_assert(SEED != 0, "no collision free hash seed for keywords found, adjust the keywords hash function");
+
+  // empty slots have an empty name, which never matches a identifier
+  constexpr array<Keyword, TABLE_SIZE> table = [] {
+    array<Keyword, TABLE_SIZE> table{};
+    for (const Keyword &keyword : keywords) {
+      table[hash(keyword.name, SEED)] = keyword;
+    }
+    return table;
+  }();
+
+
+  /**
+   * Classify a identifier with one table lookup.
+   * @param text the identifier text, has to be not empty
+   * @return the keyword token type or Identifier if text is not a keyword
+   */
+  inline TOKEN_TYPE lookup(string_view text)
+  {
+    const Keyword &slot = table[hash(text, SEED)];
+    return slot.name == text ? slot.type : Identifier;
+  }
+}
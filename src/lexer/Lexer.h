@@ -1,199 +1,74 @@
 #pragma once
 
 #include <iostream>
-#include <magic_enum.hpp>
 #include <utility>
 #include <functional>
-#include <list>
-#include <optional>
+#include <string_view>
+#include "Token.h"
+#include "TokenBuffer.h"
+#include "Keywords.h"
+#include "CharScan.h"
 using namespace std;
 
 
-enum TOKEN_TYPE
-{
-    Invalid,
-    Comment,
-    Number,
-    String,
-    Identifier,
-    Semicolon,
-    Colon,
-    Comma,
-    Dot,
-    LeftParen,
-    RightParen,
-    LeftBrace,
-    RightBrace,
-    Keyword_let,
-    Keyword_if,
-    Keyword_while,
-    Keyword_else,
-    Keyword_true,
-    Keyword_false,
-    Keyword_fun,
-    Keyword_class,
-    Keyword_extern,
-    Keyword_return,
-    Operator_Unary_Not,
-    Operator_Plus,
-    Operator_Minus,
-    Operator_Multiply,
-    Operator_Divide,
-    Operator_Assign,
-    Operator_Equals,
-    Operator_NotEquals,
-    Operator_GreaterThen,
-    Operator_GreaterEqualThen,
-    Operator_LessThen,
-    Operator_LessEqualThen,
-    Operator_LogicOr,
-    Operator_LogicAnd,
-    EndOfFile,
-};
-
-static string toString(TOKEN_TYPE tokenType) {
-  return string(magic_enum::enum_name(tokenType));
-}
-
-static string toString(vector<TOKEN_TYPE> tokenTypes) {
-  string s = "[";
-  for (int i = 0; i < tokenTypes.size(); ++i)
-  {
-    s+= toString(tokenTypes[i]);
-    if (i < tokenTypes.size() - 1) {
-      s+= ", ";
-    }
-  }
-  s+= "]";
-  return s;
-}
-
-
-class SrcLocation
+/*
+ * Lexer class
+ */
+class Lexer
 {
   public:
-    int line;
-    int column;
-    int index;
-
-    SrcLocation(int line, int columnStart, int absoluteCharIndex)
-        : column(columnStart), line(line), index(absoluteCharIndex)
-    {
-    }
-
-    string toString()
-    {
-      return "" + to_string(line) + ":" + to_string(column);
-    }
-};
-
-class SrcLocationRange {
-  public:
-    SrcLocation start;
-    optional<SrcLocation> end;
 
-    explicit SrcLocationRange(const SrcLocation &start) : start(start)
-    {
-    }
-
-    SrcLocationRange(const SrcLocation &start, const SrcLocation &end) : start(start), end(end)
-    {
-    }
 
-    SrcLocation getLastLocation() {
-      if (end) {
-        return *end;
-      } else {
-        return start;
-      }
-    }
-
-    string toString()
+    /**
+     * @param text the source text, it is not copied and has to outlive the lexer and all created tokens.
+     */
+    explicit Lexer(string_view text)
+        : text(text.data()), size(text.size())
     {
-      if (end) {
-        return start.toString() + " to " + end->toString();
-      } else {
-        return start.toString();
+      if (size >= SrcLocationRange::INVALID_OFFSET) {
+        throw length_error("source text with " + to_string(size) + " characters is too large, locations are limited to 32 bit offsets");
       }
     }
-};
-
 
-class Token
-{
-  public:
-    TOKEN_TYPE type;
-    string contend;
-    SrcLocationRange location;
-
-
-    Token(TOKEN_TYPE type, string contend, SrcLocationRange location)
-        : type(type), contend(std::move(contend)), location(location)
-    {
-    }
-
-    Token(TOKEN_TYPE type, char contend, SrcLocationRange location)
-        : type(type), contend(1, contend), location(location)
+    /**
+     * Lex only the part [begin, end) of the text, token locations are still relative to the start of the text.
+     * The part must not start or end within a token.
+     */
+    Lexer(string_view text, uint32_t begin, uint32_t end)
+        : Lexer(text.substr(0, end))
     {
+      index = begin;
     }
 
-    explicit Token(TOKEN_TYPE type, SrcLocationRange location)
-        : type(type), contend(""), location(location)
-    {
-    }
 
-    Token()
-        : type(Invalid), contend(), location(SrcLocation(-1, -1, -1))
+    TokenBuffer getAllTokens()
     {
-    }
-
-    string toString()
-    {
-      if (contend.length() != 0)
-      {
-        return "Token( " + string(magic_enum::enum_name(type)) + ", " + contend + " ) at [" + location.toString() + "]";
-      }
-      else
-      {
-        return "Token( " + string(magic_enum::enum_name(type)) + " ) at [" + location.toString() + "]";
-      }
-    }
-};
-
-
-/*
- * Lexer class
- */
-class Lexer
-{
-  public:
+      TokenBuffer tokens(string_view(text, size));
+      // rough guess to avoid most reallocations
+      tokens.reserve(size / 4 + 1);
+      lexTokensInto(tokens);
 
+      // add eof token at end
+      // @todo add eof token when it appears in input text
+      Token eofToken = Token(EndOfFile, SrcLocationRange(index));
+      tokens.push_back(eofToken);
 
-    explicit Lexer(string &text)
-        : text(text.c_str()), size(text.size() + 1)
-    {
-      // @todo size should be text.size()
-      // cout << "-- file size " << size << endl;
+      return tokens;
     }
 
 
-    list <Token> getAllTokens()
+    /**
+     * Append all tokens until the end of the text except comments and the EndOfFile token.
+     */
+    void lexTokensInto(TokenBuffer &tokens)
     {
-      list <Token> tokenList;
-      for (Token token = getNextToken(); !atEndOfFile(); token = getNextToken())
+      for (Token token = getNextToken(); token.type != EndOfFile; token = getNextToken())
       {
         // ignore comments
         if (token.type != Comment) {
-          tokenList.push_back(token);
+          tokens.push_back(token);
         }
       }
-
-      // add eof token at end
-      // @todo add eof token when it appears in input text
-      Token eofToken = Token(EndOfFile, SrcLocationRange(location));
-      tokenList.push_back(eofToken);
-
-      return tokenList;
     }
 
 
@@ -204,7 +79,7 @@ class Lexer
 
       if (atEndOfFile())
       {
-        return Token(EndOfFile, SrcLocationRange(location));
+        return Token(EndOfFile, SrcLocationRange(index));
       }
 
 
@@ -303,86 +178,58 @@ class Lexer
       // @todo parse end of file
 
       // fallback
-      Token token(Invalid, getCurrentChar(), SrcLocationRange(location));
+      Token token(Invalid, getSubText(index, index + 1), SrcLocationRange(index, 1));
       nextChar();
       return token;
     }
 
     bool atEndOfFile()
     {
-      return location.index >= size;
+      return index >= size;
     }
 
   private:
     const char *text;
     const unsigned long size;
-    SrcLocation location = SrcLocation(1, 1, 0);
+    /** offset of the current char, line and column are computed by the SourceManager when needed */
+    uint32_t index = 0;
 
 
     Token makeSingleCharToken(TOKEN_TYPE type)
     {
-      SrcLocationRange l(location);
+      uint32_t start = index;
       nextChar();
-      return Token(type, SrcLocationRange(l));
+      return Token(type, SrcLocationRange(start, 1));
     }
 
     Token makeDoubleCharToken(TOKEN_TYPE type)
     {
-      auto start = location;
+      uint32_t start = index;
       nextChar();
       nextChar();
-      auto end = location;
-      return Token(type, SrcLocationRange(SrcLocationRange(start, end)));
+      return Token(type, SrcLocationRange(start, 2));
     }
 
     Token makeIdentifierOrKeyword()
     {
-      SrcLocation start = location;
+      uint32_t start = index;
 
       // over all identifier chars
-      skipCharsWhile([this]()
-                     {
-                       return isSymbolChar(getCurrentChar()) != NO_IDENTIFIER_CHAR;
-                     });
-      SrcLocation end = location;
+      index = charScan::skipIdentifierChars(text, index, size);
 
-      // char array subpart to string
-      string contend = getSubText(start.index, end.index);
+      // char array subpart
+      string_view contend = getSubText(start, index);
 
       // check if it is keyword
-      if (contend == "let"){
-        return Token(Keyword_let, SrcLocationRange(start, end));
-      }
-      if (contend == "if"){
-        return Token(Keyword_if, SrcLocationRange(start, end));
-      }
-      if (contend == "while"){
-        return Token(Keyword_while, SrcLocationRange(start, end));
-      }
-      if (contend == "else"){
-        return Token(Keyword_else, SrcLocationRange(start, end));
-      }
-      if (contend == "true"){
-        return Token(Keyword_true, SrcLocationRange(start, end));
-      }
-      if (contend == "false"){
-        return Token(Keyword_false, SrcLocationRange(start, end));
-      }
-      if (contend == "fun"){
-        return Token(Keyword_fun, SrcLocationRange(start, end));
-      }
-      if (contend == "class"){
-        return Token(Keyword_class, SrcLocationRange(start, end));
-      }
-      if (contend == "extern"){
-        return Token(Keyword_extern, SrcLocationRange(start, end));
-      }
-      if (contend == "return"){
-        return Token(Keyword_return, SrcLocationRange(start, end));
+      TOKEN_TYPE type = keywords::lookup(contend);
+      if (type != Identifier) {
+        return Token(type, rangeFrom(start));
       }
 
       // if not a keyword its a identifier
-      return Token(Identifier, contend, SrcLocationRange(start, end));
+      Token token(Identifier, contend, rangeFrom(start));
+      token.symbol = contend;
+      return token;
     }
 
 
@@ -392,35 +239,28 @@ class Lexer
      */
     Token makeString()
     {
-      SrcLocation start = location;
+      uint32_t start = index;
 
       // skip initial "
       nextChar();
-      SrcLocation startText = location;
+      uint32_t startText = index;
 
-      // over all identifier chars
-      skipCharsWhile([this]()
-                     {
-                       return !isStringStartEndChar(getCurrentChar());
-                     });
-      SrcLocation endText = location;
+      // over all chars until end "
+      index = charScan::find(text, index, size, '"');
+      uint32_t endText = index;
 
       // skip end "
       nextChar();
-      SrcLocation end = location;
 
-      // char array subpart to string
-      return Token(String, getSubText(startText.index, endText.index), SrcLocationRange(start, end));
+      // char array subpart
+      return Token(String, getSubText(startText, endText), rangeFrom(start));
     }
 
     Token makeNumber()
     {
-      SrcLocation start = location;
+      uint32_t start = index;
       // first digits
-      skipCharsWhile([this]()
-                     {
-                       return isDigitChar(getCurrentChar());
-                     });
+      index = charScan::skipDigits(text, index, size);
 
       // dot
       if (isDotChar(getCurrentChar()))
@@ -428,59 +268,46 @@ class Lexer
         nextChar();
 
         // get the part after dot
-        skipCharsWhile([this]()
-                       {
-                         return isDigitChar(getCurrentChar());
-                       });
+        index = charScan::skipDigits(text, index, size);
       }
 
-      SrcLocation end = location;
-
-      // char array subpart to string
-      return Token(Number, getSubText(start.index, end.index), SrcLocationRange(start, end));
+      // char array subpart
+      return Token(Number, getSubText(start, index), rangeFrom(start));
     }
 
 
     Token makeOneLineComment() {
-      SrcLocation start = location;
+      uint32_t start = index;
 
       // both '/'
       nextChar();
       nextChar();
-      SrcLocation startText = location;
+      uint32_t startText = index;
 
       // skip all until next line
-      skipCharsWhile([this]()
-                     {
-                       return isSpaceChar(getCurrentChar()) != NEW_LINE;
-                     });
+      index = charScan::find(text, index, size, '\n');
 
-      SrcLocation end = location;
-      return Token(Comment, getSubText(startText.index, end.index), SrcLocationRange(start, end));
+      return Token(Comment, getSubText(startText, index), rangeFrom(start));
     }
 
 
     Token makeMultiLineComment() {
-      SrcLocation start = location;
+      uint32_t start = index;
 
       // '/*'
       nextChar();
       nextChar();
-      SrcLocation startText = location;
+      uint32_t startText = index;
 
-      // skip all until next line
-      skipCharsWhile([this]()
-                     {
-                       return !(getCurrentChar() == '*' && compareNextCharWith('/'));
-                     });
-      SrcLocation endText = location;
+      // skip all until '*/'
+      index = charScan::findMultiLineCommentEnd(text, index, size);
+      uint32_t endText = index;
 
       // '*/'
       nextChar();
       nextChar();
 
-      SrcLocation end = location;
-      return Token(Comment, getSubText(startText.index, endText.index), SrcLocationRange(start, end));
+      return Token(Comment, getSubText(startText, endText), rangeFrom(start));
     }
 
 
@@ -492,43 +319,37 @@ class Lexer
       if (atEndOfFile())
       {
         throw out_of_range(
-            "character at position " + location.toString() + " is after file end (file has " + to_string(size)
+            "character at position " + sourceManager.getSrcLocation(index).toString() + " is after file end (file has " + to_string(size)
                 + " characters)");
       }
 
-      location.index++;
-      location.column++;
+      index++;
     }
 
+    /**
+     * @return the current char or '\0' when at end of file
+     */
     char getCurrentChar()
     {
-      return text[location.index];
+      if (atEndOfFile()) {
+        return '\0';
+      }
+      return text[index];
     }
 
     bool compareNextCharWith(char compareWith)
     {
-      if (atEndOfFile()) {
+      if (index + 1 >= size) {
         return false;
       } else {
-        return text[location.index + 1] == compareWith;
+        return text[index + 1] == compareWith;
       }
     }
 
 
     void skipSpaces()
     {
-      SPACE_TYPE space = isSpaceChar(getCurrentChar());
-      while (space != NO_SPACE && !atEndOfFile())
-      {
-        if (space == NEW_LINE)
-        {
-          location.line++;
-          location.column = 0;
-        }
-
-        nextChar();
-        space = isSpaceChar(getCurrentChar());
-      }
+      index = charScan::skipSpaces(text, index, size);
     }
 
 
@@ -674,24 +495,20 @@ class Lexer
       }
     }
 
-    string getSubText(int start, int end) const
+    /**
+     * @return view into the source text, no copy is made
+     */
+    string_view getSubText(uint32_t start, uint32_t end) const
     {
-      string contend;
-      contend.assign(text, start, end - start);
-      return contend;
+      return string_view(text + start, end - start);
     }
 
-    void skipCharsWhile(function<bool()> condition)
+    /**
+     * @return the range from start to the current char (exclusive)
+     */
+    SrcLocationRange rangeFrom(uint32_t start) const
     {
-      while (condition() && !atEndOfFile())
-      {
-        if (isSpaceChar(getCurrentChar()) == NEW_LINE)
-        {
-          location.line++;
-          location.column = 0;
-        }
-        nextChar();
-      }
+      return SrcLocationRange(start, index - start);
     }
 };
 
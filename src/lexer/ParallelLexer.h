@@ -0,0 +1,120 @@
+#pragma once
+
+#include <vector>
+#include <string_view>
+#include "Lexer.h"
+#include "CharScan.h"
+#include "TokenBuffer.h"
+#include "util/Parallel.h"
+using namespace std;
+
+
+/**
+ * Lexes large source texts on multiple threads.
+ * The text is split into chunks at new lines that are not within a string or comment,
+ * each chunk is lexed by its own Lexer and the token buffers are joined in order.
+ * Because token locations are offsets into the whole text no locations need to be adjusted,
+ * the result is the same as of Lexer::getAllTokens().
+ */
+class ParallelLexer
+{
+  public:
+    /** texts smaller than this are not split */
+    static constexpr size_t MIN_CHUNK_SIZE = 256 * 1024;
+
+    /**
+     * @param text the source text, it is not copied and has to outlive the lexer and all created tokens.
+     */
+    explicit ParallelLexer(string_view text) : text(text)
+    {}
+
+    /**
+     * @throws the first exception (in text order) of the chunk lexers
+     */
+    TokenBuffer getAllTokens(unsigned threadsCount = getWorkerThreadsCount())
+    {
+      size_t chunksCount = max<size_t>(1, min<size_t>(threadsCount, text.size() / MIN_CHUNK_SIZE));
+      if (chunksCount == 1) {
+        return Lexer(text).getAllTokens();
+      }
+
+      vector<uint32_t> boundaries = findChunkBoundaries(chunksCount);
+      vector<TokenBuffer> chunkTokens(boundaries.size() - 1, TokenBuffer(text));
+      parallelFor(chunkTokens.size(), [&](size_t chunk) {
+        uint32_t begin = boundaries[chunk];
+        uint32_t end = boundaries[chunk + 1];
+        chunkTokens[chunk].reserve((end - begin) / 4 + 1);
+        Lexer(text, begin, end).lexTokensInto(chunkTokens[chunk]);
+      }, threadsCount);
+
+      // join
+      size_t tokensCount = 1;
+      for (auto &tokens : chunkTokens) {
+        tokensCount += tokens.size();
+      }
+      TokenBuffer tokens(text);
+      tokens.reserve(tokensCount);
+      for (auto &chunk : chunkTokens) {
+        tokens.append(chunk);
+      }
+      tokens.push_back(Token(EndOfFile, SrcLocationRange(text.size())));
+      return tokens;
+    }
+
+  private:
+    string_view text;
+
+    /**
+     * Find positions to split the text into about chunksCount chunks of similar size.
+     * Chunks start after a new line that is not within a string or comment.
+     * Strings and comments are tracked the same way the Lexer does, this is a sequential pass
+     * but it only looks at the chars '"', '/' and the ends of strings and comments.
+     * @return offsets of the chunk starts followed by the text size
+     */
+    vector<uint32_t> findChunkBoundaries(size_t chunksCount)
+    {
+      const char *data = text.data();
+      size_t size = text.size();
+      size_t chunkSize = size / chunksCount;
+
+      vector<uint32_t> boundaries = {0};
+      size_t nextSplit = chunkSize;
+      size_t i = 0;
+      while (i < size && boundaries.size() < chunksCount) {
+        size_t special = charScan::findAny(data, i, size, '"', '/');
+
+        // all text until the special char is plain code: split at first new line after the wanted split position
+        while (nextSplit < special && boundaries.size() < chunksCount) {
+          size_t newLine = charScan::find(data, max(nextSplit, i), special, '\n');
+          if (newLine >= special) {
+            break;
+          }
+          boundaries.push_back(newLine + 1);
+          nextSplit = newLine + 1 + chunkSize;
+        }
+
+        if (special >= size) {
+          break;
+        }
+        if (data[special] == '"') {
+          // skip string until closing "
+          i = charScan::find(data, special + 1, size, '"') + 1;
+        }
+        else if (special + 1 < size && data[special + 1] == '/') {
+          // one line comment ends before new line
+          i = charScan::find(data, special + 2, size, '\n');
+        }
+        else if (special + 1 < size && data[special + 1] == '*') {
+          i = charScan::findMultiLineCommentEnd(data, special + 2, size) + 2;
+        }
+        else {
+          // divide operator
+          i = special + 1;
+        }
+      }
+
+      boundaries.erase(remove_if(boundaries.begin() + 1, boundaries.end(), [size](uint32_t b) { return b >= size; }), boundaries.end());
+      boundaries.push_back(size);
+      return boundaries;
+    }
+};
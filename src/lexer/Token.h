@@ -0,0 +1,164 @@
+#pragma once
+
+#include <iostream>
+#include <magic_enum.hpp>
+#include <utility>
+#include <optional>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+#include "SourceManager.h"
+#include "util/Symbol.h"
+using namespace std;
+
+
+enum TOKEN_TYPE: uint8_t
+{
+    Invalid,
+    Comment,
+    Number,
+    String,
+    Identifier,
+    Semicolon,
+    Colon,
+    Comma,
+    Dot,
+    LeftParen,
+    RightParen,
+    LeftBrace,
+    RightBrace,
+    Keyword_let,
+    Keyword_if,
+    Keyword_while,
+    Keyword_else,
+    Keyword_true,
+    Keyword_false,
+    Keyword_fun,
+    Keyword_class,
+    Keyword_extern,
+    Keyword_return,
+    Operator_Unary_Not,
+    Operator_Plus,
+    Operator_Minus,
+    Operator_Multiply,
+    Operator_Divide,
+    Operator_Assign,
+    Operator_Equals,
+    Operator_NotEquals,
+    Operator_GreaterThen,
+    Operator_GreaterEqualThen,
+    Operator_LessThen,
+    Operator_LessEqualThen,
+    Operator_LogicOr,
+    Operator_LogicAnd,
+    EndOfFile,
+};
+
+static string toString(TOKEN_TYPE tokenType) {
+  return string(magic_enum::enum_name(tokenType));
+}
+
+static string toString(vector<TOKEN_TYPE> tokenTypes) {
+  string s = "[";
+  for (int i = 0; i < tokenTypes.size(); ++i)
+  {
+    s+= toString(tokenTypes[i]);
+    if (i < tokenTypes.size() - 1) {
+      s+= ", ";
+    }
+  }
+  s+= "]";
+  return s;
+}
+
+
+/**
+ * Range in the source text stored as byte offset and length.
+ * Line and column are only computed when needed (e.g. for messages) by the SourceManager.
+ */
+class SrcLocationRange {
+  public:
+    static constexpr uint32_t INVALID_OFFSET = UINT32_MAX;
+
+    /** byte offset of the first char in the source text */
+    uint32_t offset = INVALID_OFFSET;
+    /** amount of chars in the range, 0 for a single position */
+    uint32_t length = 0;
+
+    SrcLocationRange() = default;
+
+    explicit SrcLocationRange(uint32_t offset, uint32_t length = 0) : offset(offset), length(length)
+    {
+    }
+
+    bool isValid() const {
+      return offset != INVALID_OFFSET;
+    }
+
+    /**
+     * @return offset of the char after the range
+     */
+    uint32_t getEndOffset() const {
+      return offset + length;
+    }
+
+    SrcLocation getStart() const {
+      return sourceManager.getSrcLocation(offset);
+    }
+
+    /**
+     * @return location of the char after the range
+     */
+    SrcLocation getEnd() const {
+      return isValid() ? sourceManager.getSrcLocation(getEndOffset()) : getStart();
+    }
+
+    string toString() const
+    {
+      if (length > 0) {
+        return getStart().toString() + " to " + getEnd().toString();
+      } else {
+        return getStart().toString();
+      }
+    }
+};
+
+
+class Token
+{
+  public:
+    TOKEN_TYPE type;
+    /** points into the source text, the source is owned by the SourceManager */
+    string_view contend;
+    /** interned contend, only set for identifiers */
+    Symbol symbol;
+    SrcLocationRange location;
+
+
+    Token(TOKEN_TYPE type, string_view contend, SrcLocationRange location)
+        : type(type), contend(contend), location(location)
+    {
+    }
+
+    explicit Token(TOKEN_TYPE type, SrcLocationRange location)
+        : type(type), contend(""), location(location)
+    {
+    }
+
+    Token()
+        : type(Invalid), contend(), location()
+    {
+    }
+
+    string toString()
+    {
+      if (contend.length() != 0)
+      {
+        return "Token( " + string(magic_enum::enum_name(type)) + ", " + string(contend) + " ) at [" + location.toString() + "]";
+      }
+      else
+      {
+        return "Token( " + string(magic_enum::enum_name(type)) + " ) at [" + location.toString() + "]";
+      }
+    }
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vector>
+#include <string_view>
+#include "Token.h"
+using namespace std;
+
+
+/**
+ * Contiguous and index addressable list of tokens.
+ * Tokens are stored as struct of arrays (types, locations and symbols),
+ * thus looking at the type of the next tokens is a plain array access.
+ * The contend of a token is not stored, it is derived from its location and type
+ * and points into the source text, which has to outlive the buffer.
+ */
+class TokenBuffer
+{
+  public:
+    TokenBuffer() = default;
+
+    /**
+     * @param source the source text the token contend points into
+     */
+    explicit TokenBuffer(string_view source) : source(source.data())
+    {}
+
+    void reserve(size_t tokensAmount) {
+      types.reserve(tokensAmount);
+      locations.reserve(tokensAmount);
+      symbols.reserve(tokensAmount);
+    }
+
+    /**
+     * Append a token, its contend has to be the one produced by the lexer for its location.
+     */
+    void push_back(const Token &token) {
+      types.push_back(token.type);
+      locations.push_back(token.location);
+      symbols.push_back(token.symbol);
+    }
+
+    /**
+     * Append all tokens of the other buffer, both have to use the same source text.
+     */
+    void append(const TokenBuffer &other) {
+      types.insert(types.end(), other.types.begin(), other.types.end());
+      locations.insert(locations.end(), other.locations.begin(), other.locations.end());
+      symbols.insert(symbols.end(), other.symbols.begin(), other.symbols.end());
+    }
+
+    size_t size() const {
+      return types.size();
+    }
+
+    bool empty() const {
+      return types.empty();
+    }
+
+    TOKEN_TYPE getType(size_t index) const {
+      return types[index];
+    }
+
+    /**
+     * Identifiers, numbers and invalid chars cover their whole location,
+     * strings the location without the enclosing quotes.
+     * All other tokens have no contend.
+     */
+    string_view getContend(size_t index) const {
+      const SrcLocationRange &location = locations[index];
+      switch (types[index]) {
+        case Identifier:
+        case Number:
+        case Invalid:
+          return string_view(source + location.offset, location.length);
+        case String:
+          return string_view(source + location.offset + 1, location.length - 2);
+        default:
+          return string_view();
+      }
+    }
+
+    const SrcLocationRange &getLocation(size_t index) const {
+      return locations[index];
+    }
+
+    /**
+     * Create a Token object for the token at index.
+     */
+    Token getToken(size_t index) const {
+      Token token(getType(index), getContend(index), getLocation(index));
+      token.symbol = symbols[index];
+      return token;
+    }
+
+  private:
+    const char *source = nullptr;
+    vector<TOKEN_TYPE> types;
+    vector<SrcLocationRange> locations;
+    vector<Symbol> symbols;
+};
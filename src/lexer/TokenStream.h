@@ -0,0 +1,177 @@
+#pragma once
+
+#include <array>
+#include "Token.h"
+#include "TokenBuffer.h"
+#include "Lexer.h"
+using namespace std;
+
+
+/**
+ * Tokens as seen by the parser: the current token and a small lookahead.
+ * The tokens either come from a TokenBuffer with all tokens of a file
+ * or are pulled on demand from a Lexer (streaming), then only the lookahead tokens are kept in a ring buffer.
+ */
+class TokenStream
+{
+  public:
+    /** max amount of tokens that can be looked at ahead of the current token */
+    static constexpr size_t MAX_LOOKAHEAD = 3;
+
+    explicit TokenStream(TokenBuffer &&tokens) : tokens(move(tokens)), tokensEnd(this->tokens.size())
+    {}
+
+    /**
+     * Stream over the tokens [begin, end) of a buffer that is owned by someone else,
+     * used to parse parts of a file later (e.g. lazy function bodies).
+     * The buffer has to outlive the stream.
+     */
+    TokenStream(const TokenBuffer &tokens, size_t begin, size_t end)
+        : externalTokens(&tokens), tokenIndex(begin), tokensEnd(end)
+    {}
+
+    /**
+     * Streaming mode, the lexer has to outlive the stream.
+     */
+    explicit TokenStream(Lexer &lexer) : lexer(&lexer)
+    {}
+
+    /**
+     * @return true if there are no tokens at all
+     */
+    bool empty() const {
+      return lexer == nullptr && tokensEnd == 0;
+    }
+
+    /**
+     * @return true if all tokens have been consumed.
+     *         In streaming mode the lexer repeats the EndOfFile token, thus there are always tokens left.
+     */
+    bool atEnd() const {
+      return lexer == nullptr && tokenIndex >= tokensEnd;
+    }
+
+    /**
+     * @return true if the tokens are pulled from a lexer, then tokens have no index and can't be revisited
+     */
+    bool isStreaming() const {
+      return lexer != nullptr;
+    }
+
+    /**
+     * Index of the current token in the token buffer, not available when streaming.
+     */
+    size_t getIndex() const {
+      return tokenIndex;
+    }
+
+    /**
+     * All tokens of the buffer the stream reads from, not available when streaming.
+     */
+    const TokenBuffer &getBuffer() const {
+      return externalTokens ? *externalTokens : tokens;
+    }
+
+    /**
+     * Move the owned token buffer out of the stream, e.g. to keep it for parsing lazy function bodies later.
+     * The stream is empty afterwards.
+     */
+    TokenBuffer releaseTokens() {
+      tokenIndex = tokensEnd = 0;
+      return move(tokens);
+    }
+
+    /**
+     * @param lookahead 0 for the current token, 1 for the token after it, ...
+     * @return token type or EndOfFile when the end is reached
+     */
+    TOKEN_TYPE getType(size_t lookahead = 0) {
+      if (lexer) {
+        return lookaheadToken(lookahead).type;
+      }
+      if (tokenIndex + lookahead >= tokensEnd) {
+        return EndOfFile;
+      }
+      return getBuffer().getType(tokenIndex + lookahead);
+    }
+
+    /**
+     * @param lookahead 0 for the current token, 1 for the token after it, ...
+     * @return token or a EndOfFile token at the end of the tokens when the end is reached,
+     *         tokens of the buffer after the end (e.g. of the next chunk) are never returned
+     */
+    Token getToken(size_t lookahead = 0) {
+      if (lexer) {
+        return lookaheadToken(lookahead);
+      }
+      if (tokenIndex + lookahead >= tokensEnd) {
+        return Token(EndOfFile, getEndLocation());
+      }
+      return getBuffer().getToken(tokenIndex + lookahead);
+    }
+
+    SrcLocationRange getLocation(size_t lookahead = 0) {
+      if (lexer) {
+        return lookaheadToken(lookahead).location;
+      }
+      if (tokenIndex + lookahead >= tokensEnd) {
+        return getEndLocation();
+      }
+      return getBuffer().getLocation(tokenIndex + lookahead);
+    }
+
+    /**
+     * Move to the next token.
+     */
+    void next() {
+      if (lexer) {
+        lookaheadToken(0);
+        ringStart = (ringStart + 1) % RING_SIZE;
+        ringUsed--;
+      }
+      else {
+        tokenIndex++;
+      }
+    }
+
+  private:
+    static constexpr size_t RING_SIZE = MAX_LOOKAHEAD + 1;
+
+    // buffer mode
+    TokenBuffer tokens;
+    /** when set the tokens of this buffer are used instead of the owned tokens */
+    const TokenBuffer *externalTokens = nullptr;
+    size_t tokenIndex = 0;
+    size_t tokensEnd = 0;
+
+    // streaming mode
+    Lexer *lexer = nullptr;
+    array<Token, RING_SIZE> ring;
+    size_t ringStart = 0;
+    size_t ringUsed = 0;
+
+    /**
+     * Position directly after the last token of the stream.
+     */
+    SrcLocationRange getEndLocation() const {
+      if (tokensEnd == 0) {
+        return SrcLocationRange();
+      }
+      return SrcLocationRange(getBuffer().getLocation(tokensEnd - 1).getEndOffset());
+    }
+
+    /**
+     * Get a token of the ring buffer, pulls tokens from the lexer until it is available.
+     */
+    const Token &lookaheadToken(size_t lookahead) {
+      while (ringUsed <= lookahead) {
+        Token token = lexer->getNextToken();
+        // ignore comments
+        if (token.type != Comment) {
+          ring[(ringStart + ringUsed) % RING_SIZE] = token;
+          ringUsed++;
+        }
+      }
+      return ring[(ringStart + lookahead) % RING_SIZE];
+    }
+};
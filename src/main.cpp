@@ -8,11 +8,13 @@
 #include "Log.h"
 #include "File.hpp"
 #include "lexer/Lexer.h"
+#include "lexer/ParallelLexer.h"
 #include "parser/Parser.h"
 #include "SourceManager.h"
 #include "AstVisitor/AstCodePrinter.h"
 #include "AstVisitor/AstPrinter.h"
 #include "decorator/AstDecorator.h"
+#include "AstCache/AstCache.h"
 #include "ir/gen/IRGenerator.h"
 #include "ir/visitor/IRVisitor.h"
 #include "ir/printer/IRPrinter.h"
@@ -40,6 +42,12 @@ bool saveLLvmIR = false;
 bool notWriteObjectFile = false;
 bool runCompiled = false;
 bool useIR = false;
+bool streamTokens = false;
+bool parallelLexing = false;
+bool lazyParsing = false;
+bool parallelParsing = false;
+bool useAstCache = false;
+bool parallelDecorating = false;
 string viewFunctionLLvmGraph = "";
 string srcFile;
 
@@ -107,6 +115,30 @@ void parseCliArgs(const args& arguments) {
       opt(runCompiled)
           .name("--run")
           .help("runs the compiled program"));
+  cli.add_argument(
+      opt(streamTokens)
+          .name("--stream-tokens")
+          .help("lex while parsing instead of lexing the whole file first, keeps only a few tokens in memory (can't be combined with --show-lexer-output)"));
+  cli.add_argument(
+      opt(parallelLexing)
+          .name("--parallel-lexing")
+          .help("lex large files in chunks on multiple threads"));
+  cli.add_argument(
+      opt(lazyParsing)
+          .name("--lazy-parsing")
+          .help("parse function bodies only when they are reachable from main, unreachable functions are not checked and not compiled (can't be combined with --stream-tokens)"));
+  cli.add_argument(
+      opt(parallelParsing)
+          .name("--parallel-parsing")
+          .help("parse the global declarations of large files on multiple threads (can't be combined with --stream-tokens)"));
+  cli.add_argument(
+      opt(parallelDecorating)
+          .name("--parallel-decorating")
+          .help("decorate the bodies of functions and classes on multiple threads (has no effect with --lazy-parsing)"));
+  cli.add_argument(
+      opt(useAstCache)
+          .name("--ast-cache")
+          .help("reuse the decorated ast of an unchanged source file from the folder '.malinc-cache' instead of lexing, parsing and decorating it again"));
     cli.add_argument(
         opt(useIR)
             .name("--use-ir")
@@ -147,84 +179,120 @@ int main(int argc, const char **argv)
   // -------------------------------
   // -- read file
   cout << termcolor::bold << "- read file:" << termcolor::reset <<endl;
-  string fileContend;
+  string_view fileContend;
   fs::path filePath(srcFile);
   try {
-    fileContend = File::readFile(filePath);
+    // file is memory mapped and owned by the sourceManager
+    fileContend = sourceManager.loadSource(filePath);
   } catch (runtime_error &e) {
     error("Error while reading file", e);
     exitWithError();
   }
   cout << "-- file has " << fileContend.size() << " characters" << endl << endl;
-  sourceManager.setSource(filePath, fileContend);
 
 
 
   // -------------------------------
-  // -- lexing
-  cout << termcolor::bold << "- lexing:" << termcolor::reset << endl;
-  Lexer lexer(fileContend);
-
-  list<Token> tokenList;
-  try {
-    tokenList = lexer.getAllTokens();
-  }
-  catch (exception &e) {
-    error("Error while lexing", e);
-    exitWithError();
+  // -- ast cache
+  RootDeclarations root;
+  AstCache astCache;
+  bool loadedFromCache = false;
+  if (useAstCache) {
+    loadedFromCache = astCache.load(fileContend, root);
+    cout << "-- ast cache " << (loadedFromCache ? "hit, skip lexing, parsing and decorating" : "miss") << endl << endl;
   }
 
-  if (showLexerOutput) {
-    cout << "-- tokens:" << termcolor::reset << endl;
-    for (Token token : tokenList) {
-      cout << fs::canonical(filePath).string() << ":" << token.location.start.toString() << ": " /* << endl << "\t\t" */ << token.toString() << endl;
+  if (!loadedFromCache) {
+    // -------------------------------
+    // -- lexing
+    cout << termcolor::bold << "- lexing:" << termcolor::reset << endl;
+    Lexer lexer(fileContend);
+
+    TokenBuffer tokens;
+    if (streamTokens) {
+      cout << "-- tokens are lexed while parsing" << endl;
+    }
+    else {
+      try {
+        tokens = parallelLexing ? ParallelLexer(fileContend).getAllTokens() : lexer.getAllTokens();
+      }
+      catch (exception &e) {
+        error("Error while lexing", e);
+        exitWithError();
+      }
     }
-  }
-  cout << "-- lexing " << termcolor::green << "done" << termcolor::reset << endl << endl;
 
+    if (showLexerOutput && !streamTokens) {
+      cout << "-- tokens:" << termcolor::reset << endl;
+      for (size_t i = 0; i < tokens.size(); i++) {
+        Token token = tokens.getToken(i);
+        cout << fs::canonical(filePath).string() << ":" << token.location.getStart().toString() << ": " /* << endl << "\t\t" */ << token.toString() << endl;
+      }
+    }
+    cout << "-- lexing " << termcolor::green << "done" << termcolor::reset << endl << endl;
 
 
-  // -------------------------------
-  // -- parsing
-  cout << termcolor::bold << "- parsing:" << termcolor::reset << endl;
-  Parser parser(move(tokenList));
-  RootDeclarations root;
-  try {
-    root = parser.parse();
-  }
-  catch (ParseException &e) {
-    printError(
-        "parse",
-        e.what(),
-        e.token.location);
-    exitWithError();
-  }
 
-  if (showParserOutput) {
-    cout << "-- ast:" << termcolor::reset;
-    AstPrinter printer(std::cout);
-    printer.printTree(root);
-  }
-  cout << "-- parsing " << termcolor::green << "done" << termcolor::reset << endl << endl;
+    // -------------------------------
+    // -- parsing
+    cout << termcolor::bold << "- parsing:" << termcolor::reset << endl;
+    Parser parser = streamTokens ? Parser(TokenStream(lexer)) : Parser(move(tokens));
+    parser.setLazyFunctionBodies(lazyParsing);
+    try {
+      root = parallelParsing ? parser.parseParallel() : parser.parse();
+    }
+    catch (ParseException &e) {
+      printError(
+          "parse",
+          e.what(),
+          e.token.location);
+      exitWithError();
+    }
+    catch (exception &e) {
+      // when streaming tokens lexer errors appear while parsing
+      error("Error while lexing", e);
+      exitWithError();
+    }
 
+    if (showParserOutput) {
+      cout << "-- ast:" << termcolor::reset;
+      AstPrinter printer(std::cout);
+      printer.printTree(root);
+    }
+    cout << "-- parsing " << termcolor::green << "done" << termcolor::reset << endl << endl;
 
 
-  // -------------------------------
-  // -- decorate
-  cout << termcolor::bold << "- decorate ast:" << termcolor::reset << endl;
-  AstDecorator astDecorator;
-  bool decoOk = astDecorator.linkNames(root);
-
-  if (showDecoratorOutput) {
-    cout << "-- ast:" << termcolor::reset;
-    AstPrinter printer(std::cout);
-    printer.printTree(root);
-  }
 
-  if (!decoOk) {
-    exitWithError();
+    // -------------------------------
+    // -- decorate
+    cout << termcolor::bold << "- decorate ast:" << termcolor::reset << endl;
+    AstDecorator astDecorator;
+    astDecorator.setParallelBodies(parallelDecorating);
+    bool decoOk = astDecorator.linkNames(root);
+
+    if (showDecoratorOutput) {
+      cout << "-- ast:" << termcolor::reset;
+      AstPrinter printer(std::cout);
+      printer.printTree(root);
+    }
+
+    if (!decoOk) {
+      exitWithError();
+    }
+    cout << "-- decorating " << termcolor::green << "done" << termcolor::reset << endl << endl;
+
+    if (useAstCache) {
+      try {
+        if (!astCache.save(fileContend, root)) {
+          cout << "-- ast not cached, it contains function bodies skipped by lazy parsing" << endl << endl;
+        }
+      }
+      catch (exception &e) {
+        // the compilation itself is still valid
+        error("Error while saving ast to cache", e);
+      }
+    }
   }
-  cout << "-- decorating " << termcolor::green << "done" << termcolor::reset << endl << endl;
 
   if (showAstAsCode) {
     AstCodePrinter astPrinter;
@@ -337,14 +405,14 @@ int main(int argc, const char **argv)
     auto funcIter = find_if(
         root.functionDeclarations.begin(),
         root.functionDeclarations.end(),
-        [](FunctionDeclaration& decl) {
-          return decl.name == viewFunctionLLvmGraph;
+        [](FunctionDeclaration *decl) {
+          return decl->name == viewFunctionLLvmGraph;
         });
-    if (funcIter == root.functionDeclarations.end()) {
+    if (funcIter == root.functionDeclarations.end() || !(*funcIter)->llvmFunction) {
       cout << "ERR:  --view-function-graph "<< viewFunctionLLvmGraph << " function not found" << endl;
       exitWithError();
     }
-    auto func = funcIter->llvmFunction;
+    auto func = (*funcIter)->llvmFunction;
     func->viewCFG();
   }
 
@@ -5,10 +5,13 @@
 #include "ir/IRValueVar.h"
 #include "ir/IRFunction.h"
 #include "util/util.h"
+#include "util/Symbol.h"
+#include "util/Casting.h"
 #include "Types.h"
 #include "lexer/Lexer.h"
 #include "AstIterator/AstNodeChildIterator.h"
 #include "AstReplacable.h"
+#include "AstArena.h"
 
 using namespace std;
 
@@ -21,12 +24,60 @@ class Expression;
 class VariableExpression;
 
 
+/**
+ * Kind of a ASTNode, used by isa<>/dyn_cast<> of the nodes and by switch based dispatch.
+ * Kinds of derived nodes of an abstract node class lie between its _First and _Last kind.
+ */
+enum AST_NODE_KIND {
+    Node_RootDeclarations,
+    Node_FunctionDeclaration,
+    Node_FunctionParamDeclaration,
+    Node_ClassDeclaration,
+    Node_CallExpressionArgument,
+
+    // statements
+    Node_Statement_First,
+    Node_VariableDeclaration = Node_Statement_First,
+    Node_ReturnStatement,
+    Node_CompoundStatement,
+    Node_IfStatement,
+    Node_WhileStatement,
+    Node_VariableAssignStatement,
+
+    // expressions
+    Node_Expression_First,
+    Node_UnaryExpression = Node_Expression_First,
+    Node_BinaryExpression,
+
+    Node_IdentifierExpression_First,
+    Node_VariableExpression = Node_IdentifierExpression_First,
+    Node_MemberVariableExpression,
+    Node_CallExpression,
+    Node_MemberCallExpression,
+    Node_IdentifierExpression_Last = Node_MemberCallExpression,
+
+    Node_ConstValueExpression_First,
+    Node_NumberIntExpression = Node_ConstValueExpression_First,
+    Node_NumberFloatExpression,
+    Node_StringExpression,
+    Node_BoolExpression,
+    Node_ConstValueExpression_Last = Node_BoolExpression,
+
+    Node_Expression_Last = Node_ConstValueExpression_Last,
+    Node_Statement_Last = Node_Expression_Last,
+};
+
+
 /**
  * Base for all AstNodes.
+ * Nodes are owned by the AstArena of the RootDeclarations, children are linked by raw pointers.
  */
 class ASTNode {
   public:
-    SrcLocationRange location = SrcLocationRange(SrcLocation(-1,-1,-1));
+    /** kind of the concrete node class, set by its constructor */
+    AST_NODE_KIND kind;
+
+    SrcLocationRange location;
 
     /** the parent node of this node in the ast tree.
      * For the RootDeclarations node and direct children of RootDeclarations this is null
@@ -34,6 +85,9 @@ class ASTNode {
      */
     ASTNode *parentAstNode = nullptr;
 
+    explicit ASTNode(AST_NODE_KIND kind) : kind(kind)
+    {}
+
     virtual ~ASTNode() {}
 
 
@@ -75,7 +129,14 @@ class ASTNode {
 
 
 class Statement: public ASTNode {
+  public:
+    static bool classof(const ASTNode *node) {
+      return node->kind >= Node_Statement_First && node->kind <= Node_Statement_Last;
+    }
 
+  protected:
+    explicit Statement(AST_NODE_KIND kind) : ASTNode(kind)
+    {}
 };
 
 
@@ -84,11 +145,15 @@ class Statement: public ASTNode {
  *** Expressions
  */
 
-/// @note replaceNode currently only works with type extending VariableExpression because self3 is VariableExpression
+/// @note replaceNode of a expression linked by self3 only works with types extending VariableExpression because self3 is VariableExpression,
 /// to fix this Child classes have to extend Replacable not Expression
 class Expression: public Statement, public Replacable<Expression, Expression, Statement, VariableExpression> {
   public:
-    unique_ptr<LangType> resultType;
+    LangType *resultType = nullptr;
+
+    static bool classof(const ASTNode *node) {
+      return node->kind >= Node_Expression_First && node->kind <= Node_Expression_Last;
+    }
 
     /**
      * points to the unique pointer that owns this Expression object, use this to replace the expression.
@@ -111,6 +176,10 @@ class Expression: public Statement, public Replacable<Expression, Expression, St
         *selfInStatement = move(replaceWith);
     }
      */
+
+  protected:
+    explicit Expression(AST_NODE_KIND kind) : Statement(kind)
+    {}
 };
 
 
@@ -133,6 +202,13 @@ static string toString(UnaryExpressionOp op) {
 
 class UnaryExpression: public Expression {
   public:
+    UnaryExpression() : Expression(Node_UnaryExpression)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_UnaryExpression;
+    }
+
     static UnaryExpressionOp tokenToBinaryExpressionOp(TOKEN_TYPE type) {
       switch (type) {
         case Operator_Unary_Not:
@@ -142,7 +218,7 @@ class UnaryExpression: public Expression {
       }
     }
 
-    unique_ptr<Expression> innerExpression;
+    Expression *innerExpression = nullptr;
     UnaryExpressionOp operation;
 
     string nodeName() override {
@@ -150,32 +226,32 @@ class UnaryExpression: public Expression {
     }
 
     AstChildRange getChildNodes() override {
-      return makeAstRange({innerExpression.get()});
+      return makeAstRange({innerExpression});
     }
 };
 
 
 /**
- * Op value is its precedence.
- * 1 is the lowest precedence.
+ * Ops of binary expression.
+ * The precedence of the ops is defined by the binding powers in parser/OperatorTable.h.
  */
 enum BinaryExpressionOp {
     Expr_Op_Invalid = -1,
 
-    EXPR_OP_LOGIC_OR = 5,
-    EXPR_OP_LOGIC_AND = 10,
+    EXPR_OP_LOGIC_OR,
+    EXPR_OP_LOGIC_AND,
 
-    EXPR_OP_EQUALS = 20,
-    EXPR_OP_NOT_EQUALS = 25,
-    EXPR_OP_GREATER_THEN = 30,
-    EXPR_OP_GREATER_EQUALS_THEN = 35,
-    EXPR_OP_LESS_THEN = 40,
-    EXPR_OP_LESS_EQUALS_THEN = 45,
+    EXPR_OP_EQUALS,
+    EXPR_OP_NOT_EQUALS,
+    EXPR_OP_GREATER_THEN,
+    EXPR_OP_GREATER_EQUALS_THEN,
+    EXPR_OP_LESS_THEN,
+    EXPR_OP_LESS_EQUALS_THEN,
 
-    Expr_Op_Plus = 50,
-    Expr_Op_Minus = 60,
-    Expr_Op_Divide = 70,
-    Expr_Op_Multiply = 80,
+    Expr_Op_Plus,
+    Expr_Op_Minus,
+    Expr_Op_Divide,
+    Expr_Op_Multiply,
 };
 
 static string toString(BinaryExpressionOp op) {
@@ -211,40 +287,15 @@ static string toString(BinaryExpressionOp op) {
 
 class BinaryExpression: public Expression {
   public:
-    static BinaryExpressionOp tokenToBinaryExpressionOp(TOKEN_TYPE type) {
-      switch (type) {
-        case Operator_Plus:
-          return Expr_Op_Plus;
-        case Operator_Minus:
-          return Expr_Op_Minus;
-        case Operator_Multiply:
-          return Expr_Op_Multiply;
-        case Operator_Divide:
-          return Expr_Op_Divide;
-        case Operator_Equals:
-          return EXPR_OP_EQUALS;
-        case Operator_NotEquals:
-          return EXPR_OP_NOT_EQUALS;
-        case Operator_GreaterThen:
-          return EXPR_OP_GREATER_THEN;
-        case Operator_GreaterEqualThen:
-          return EXPR_OP_GREATER_EQUALS_THEN;
-        case Operator_LessThen:
-          return EXPR_OP_LESS_THEN;
-        case Operator_LessEqualThen:
-          return EXPR_OP_LESS_EQUALS_THEN;
-        case Operator_LogicOr:
-          return EXPR_OP_LOGIC_OR;
-        case Operator_LogicAnd:
-          return EXPR_OP_LOGIC_AND;
+    BinaryExpression() : Expression(Node_BinaryExpression)
+    {}
 
-        default:
-          return Expr_Op_Invalid;
-      }
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_BinaryExpression;
     }
 
-    unique_ptr<Expression> lhs;
-    unique_ptr<Expression> rhs;
+    Expression *lhs = nullptr;
+    Expression *rhs = nullptr;
     BinaryExpressionOp operation;
 
 
@@ -253,7 +304,7 @@ class BinaryExpression: public Expression {
     }
 
     AstChildRange getChildNodes() override {
-      return makeAstRange({lhs.get(), rhs.get()});
+      return makeAstRange({lhs, rhs});
     }
 
 
@@ -278,14 +329,28 @@ class BinaryExpression: public Expression {
 };
 
 class IdentifierExpression: public Expression {
+  public:
+    static bool classof(const ASTNode *node) {
+      return node->kind >= Node_IdentifierExpression_First && node->kind <= Node_IdentifierExpression_Last;
+    }
 
+  protected:
+    explicit IdentifierExpression(AST_NODE_KIND kind) : Expression(kind)
+    {}
 };
 
 class VariableExpression: public IdentifierExpression {
   public:
-    string name;
+    Symbol name;
     /** links to declaration of the variable */
-    AbstractVariableDeclaration *variableDeclaration;
+    AbstractVariableDeclaration *variableDeclaration = nullptr;
+
+    VariableExpression() : IdentifierExpression(Node_VariableExpression)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_VariableExpression || node->kind == Node_MemberVariableExpression;
+    }
 
     string nodeName() override {
       return "VariableExpression";
@@ -294,6 +359,10 @@ class VariableExpression: public IdentifierExpression {
     AstChildRange getChildNodes() override {
       return makeAstRange({});
     }
+
+  protected:
+    explicit VariableExpression(AST_NODE_KIND kind) : IdentifierExpression(kind)
+    {}
 };
 
 /**
@@ -303,80 +372,122 @@ class VariableExpression: public IdentifierExpression {
  */
 class MemberVariableExpression: public VariableExpression {
   public:
+    MemberVariableExpression() : VariableExpression(Node_MemberVariableExpression)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_MemberVariableExpression;
+    }
+
     /** parent of the member has type  IdentifierExpression */
     // @todo make type IdentifierExpression
-    unique_ptr<Expression> parent; // IdentifierExpression
+    Expression *parent = nullptr; // IdentifierExpression
 
     string nodeName() override {
       return "MemberVariableExpression";
     }
 
     AstChildRange getChildNodes() override {
-      return makeAstRange({parent.get()});
+      return makeAstRange({parent});
     }
 };
 
 
 class ConstValueExpression: public Expression {
   public:
-    ConstValueExpression()= default;
-
-    ConstValueExpression(const ConstValueExpression &expression){
+    ConstValueExpression(const ConstValueExpression &expression) : Expression(expression.kind) {
       this->location = expression.location;
-      this->resultType = expression.resultType->clone();
+      this->resultType = expression.resultType;
+    }
+
+    static bool classof(const ASTNode *node) {
+      return node->kind >= Node_ConstValueExpression_First && node->kind <= Node_ConstValueExpression_Last;
     }
 
 
     /**
-     * Copy this const expression.
+     * Copy this const expression into the arena.
      * NOTE: AFTERWARDS 'parentAstNode' AND 'self' HAVE TO BE RE-ASSIGNED!
      * @return
      */
-    virtual std::unique_ptr<ConstValueExpression> clone() const = 0;
+    virtual ConstValueExpression *clone(AstArena &arena) const = 0;
 
     AstChildRange getChildNodes() override
     { return makeAstRange({}); }
+
+  protected:
+    explicit ConstValueExpression(AST_NODE_KIND kind) : Expression(kind)
+    {}
 };
 
 class NumberExpression: public ConstValueExpression {
+  public:
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_NumberIntExpression || node->kind == Node_NumberFloatExpression;
+    }
+
+  protected:
+    explicit NumberExpression(AST_NODE_KIND kind) : ConstValueExpression(kind)
+    {}
 };
 
 class NumberIntExpression: public NumberExpression {
   public:
+    NumberIntExpression() : NumberExpression(Node_NumberIntExpression)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_NumberIntExpression;
+    }
+
     int32_t value = 0;
 
     string nodeName() override {
       return "NumberIntExpression";
     }
 
-    std::unique_ptr<ConstValueExpression> clone() const override {
-      return make_unique<NumberIntExpression>(*this);
+    ConstValueExpression *clone(AstArena &arena) const override {
+      return arena.make<NumberIntExpression>(*this);
     }
 };
 
 class NumberFloatExpression: public NumberExpression {
   public:
+    NumberFloatExpression() : NumberExpression(Node_NumberFloatExpression)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_NumberFloatExpression;
+    }
+
     float value = 0;
 
     string nodeName() override {
       return "NumberFloatExpression";
     }
 
-    std::unique_ptr<ConstValueExpression> clone() const override {
-      return make_unique<NumberFloatExpression>(*this);
+    ConstValueExpression *clone(AstArena &arena) const override {
+      return arena.make<NumberFloatExpression>(*this);
     }
 };
 
 class StringExpression: public ConstValueExpression {
   public:
+    StringExpression() : ConstValueExpression(Node_StringExpression)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_StringExpression;
+    }
+
     string value;
 
     string nodeName() override {
       return "StringExpression";
     }
 
-    std::unique_ptr<ConstValueExpression> clone() const override {
-      return make_unique<StringExpression>(*this);
+    ConstValueExpression *clone(AstArena &arena) const override {
+      return arena.make<StringExpression>(*this);
     }
 };
 
@@ -385,16 +496,21 @@ class BoolExpression: public ConstValueExpression {
   public:
     bool value;
 
-    BoolExpression() = default;
-    BoolExpression(bool value) : value(value)
+    BoolExpression() : ConstValueExpression(Node_BoolExpression)
+    {}
+    BoolExpression(bool value) : ConstValueExpression(Node_BoolExpression), value(value)
     {}
 
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_BoolExpression;
+    }
+
     string nodeName() override {
       return "BoolExpression";
     }
 
-    std::unique_ptr<ConstValueExpression> clone() const override {
-      return make_unique<BoolExpression>(*this);
+    ConstValueExpression *clone(AstArena &arena) const override {
+      return arena.make<BoolExpression>(*this);
     }
 };
 
@@ -402,33 +518,47 @@ class BoolExpression: public ConstValueExpression {
 
 class CallExpressionArgument: public ASTNode {
   public:
+    CallExpressionArgument() : ASTNode(Node_CallExpressionArgument)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_CallExpressionArgument;
+    }
+
     /** the value of the function argument at the specific call */
-    unique_ptr<Expression> expression;
+    Expression *expression = nullptr;
 
     /** contains the argument name if arg was used with that name like 'arg1=value' */
-    optional<string> argName = nullopt;
+    optional<Symbol> argName = nullopt;
 
     /** links to declaration of the function argument */
-    FunctionParamDeclaration *argumentDeclaration;
+    FunctionParamDeclaration *argumentDeclaration = nullptr;
 
     string nodeName() override {
       return "CallExpressionArgument";
     }
 
     AstChildRange getChildNodes() override {
-      return makeAstRange({expression.get()});
+      return makeAstRange({expression});
     }
 };
 
 class CallExpression: public IdentifierExpression {
   public:
-    string calledName;
+    Symbol calledName;
     /// order of all arguments is fixed
     vector<CallExpressionArgument> argumentsNonNamed;
     vector<CallExpressionArgument> argumentsNamed;
 
     /** links to the function that is called */
-    FunctionDeclaration *functionDeclaration;
+    FunctionDeclaration *functionDeclaration = nullptr;
+
+    CallExpression() : IdentifierExpression(Node_CallExpression)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_CallExpression || node->kind == Node_MemberCallExpression;
+    }
 
     string nodeName() override {
       return "CallExpression";
@@ -437,10 +567,14 @@ class CallExpression: public IdentifierExpression {
 
     AstChildRange getChildNodes() override {
       return makeAstRange({}, {
-        makeContainerIter_ValueToPtr<ASTNode>(argumentsNonNamed),
-        makeContainerIter_ValueToPtr<ASTNode>(argumentsNamed)
+        makeAstContainer_ValueToPtr(argumentsNonNamed),
+        makeAstContainer_ValueToPtr(argumentsNamed)
       });
     }
+
+  protected:
+    explicit CallExpression(AST_NODE_KIND kind) : IdentifierExpression(kind)
+    {}
 };
 
 
@@ -451,18 +585,25 @@ class CallExpression: public IdentifierExpression {
  */
 class MemberCallExpression: public CallExpression {
   public:
+    MemberCallExpression() : CallExpression(Node_MemberCallExpression)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_MemberCallExpression;
+    }
+
     /** parent of the member has type IdentifierExpression */
     // @todo make type IdentifierExpression
-    unique_ptr<Expression> parent; // IdentifierExpression
+    Expression *parent = nullptr; // IdentifierExpression
 
     string nodeName() override {
       return "MemberCallExpression";
     }
 
     AstChildRange getChildNodes() override {
-      return makeAstRange({parent.get()}, {
-          makeContainerIter_ValueToPtr<ASTNode>(argumentsNonNamed),
-          makeContainerIter_ValueToPtr<ASTNode>(argumentsNamed)
+      return makeAstRange({parent}, {
+          makeAstContainer_ValueToPtr(argumentsNonNamed),
+          makeAstContainer_ValueToPtr(argumentsNamed)
       });
     }
 };
@@ -478,9 +619,9 @@ class MemberCallExpression: public CallExpression {
 // @todo make separate class for MemberVariableDeclaration
 class AbstractVariableDeclaration {
   public:
-    string name;
-    string typeName;
-    unique_ptr<LangType> type;
+    Symbol name;
+    Symbol typeName;
+    LangType *type = nullptr;
     bool isMutable = true;
 
     /** links to the allocated llvm value for the variable, when its a memberVariable this is null */
@@ -500,33 +641,53 @@ class AbstractVariableDeclaration {
     bool isMemberVariable() {
       return parentClass != nullptr;
     }
+
+    /**
+     * Get the variable declaration of a VariableDeclaration or FunctionParamDeclaration node.
+     * @return nullptr if node is not a variable declaration
+     */
+    static AbstractVariableDeclaration *fromNode(ASTNode *node);
 };
 
 class VariableDeclaration: public Statement, public AbstractVariableDeclaration {
   public:
+    VariableDeclaration() : Statement(Node_VariableDeclaration)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_VariableDeclaration;
+    }
+
     /** optional, can be none when its a class member */
-    unique_ptr<Expression> initExpression;
+    Expression *initExpression = nullptr;
 
     string nodeName() override {
       return "VariableDeclaration";
     }
 
     AstChildRange getChildNodes() override
-    { return makeAstRange({initExpression.get()}); }
+    { return makeAstRange({initExpression}); }
 };
 
 class ReturnStatement: public Statement {
   public:
-    /** the return value */
-    optional<unique_ptr<Expression>> expression;
-    unique_ptr<LangType> returnType;
+    ReturnStatement() : Statement(Node_ReturnStatement)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_ReturnStatement;
+    }
+
+    /** the return value, optional */
+    Expression *expression = nullptr;
+    LangType *returnType = nullptr;
 
     string nodeName() override {
       return "ReturnStatement";
     }
 
     AstChildRange getChildNodes() override {
-      return makeAstRange({expression->get()});
+      return makeAstRange({expression});
     }
 };
 
@@ -541,7 +702,14 @@ class ReturnStatement: public Statement {
  */
 class CompoundStatement: public Statement {
   public:
-    vector<unique_ptr<Statement>> statements;
+    CompoundStatement() : Statement(Node_CompoundStatement)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_CompoundStatement;
+    }
+
+    vector<Statement*> statements;
 
     string nodeName() override {
       return "CompoundStatement";
@@ -549,7 +717,7 @@ class CompoundStatement: public Statement {
 
     AstChildRange getChildNodes() override {
       return makeAstRange({}, {
-          makeContainerIter_SmartPtrToPtr<ASTNode>(statements)
+          makeAstContainer(statements)
       });
     }
 };
@@ -557,49 +725,67 @@ class CompoundStatement: public Statement {
 
 class IfStatement: public Statement {
   public:
-    unique_ptr<Expression> condition;
-    unique_ptr<CompoundStatement> ifBody;
-    unique_ptr<CompoundStatement> elseBody;
+    IfStatement() : Statement(Node_IfStatement)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_IfStatement;
+    }
+
+    Expression *condition = nullptr;
+    CompoundStatement *ifBody = nullptr;
+    CompoundStatement *elseBody = nullptr;
 
     string nodeName() override {
       return "IfStatement";
     }
 
     AstChildRange getChildNodes() override {
-      if (elseBody)
-        return makeAstRange({condition.get(), ifBody.get(), elseBody.get()});
-      else
-        return makeAstRange({condition.get(), ifBody.get()});
+      return makeAstRange({condition, ifBody, elseBody});
     }
 };
 
 
 class WhileStatement: public Statement {
   public:
-    unique_ptr<Expression> condition;
-    unique_ptr<CompoundStatement> body;
+    WhileStatement() : Statement(Node_WhileStatement)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_WhileStatement;
+    }
+
+    Expression *condition = nullptr;
+    CompoundStatement *body = nullptr;
 
     string nodeName() override {
       return "WhileStatement";
     }
 
     AstChildRange getChildNodes() override {
-      return makeAstRange({condition.get(), body.get()});
+      return makeAstRange({condition, body});
     }
 };
 
 
 class VariableAssignStatement: public Statement {
   public:
-    unique_ptr<Expression> valueExpression;
-    unique_ptr<VariableExpression> variableExpression;
+    VariableAssignStatement() : Statement(Node_VariableAssignStatement)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_VariableAssignStatement;
+    }
+
+    Expression *valueExpression = nullptr;
+    VariableExpression *variableExpression = nullptr;
 
     string nodeName() override {
       return "VariableAssignStatement";
     }
 
     AstChildRange getChildNodes() override {
-      return makeAstRange({variableExpression.get(), valueExpression.get()});
+      return makeAstRange({variableExpression, valueExpression});
     }
 };
 
@@ -611,26 +797,44 @@ class VariableAssignStatement: public Statement {
 
 class FunctionParamDeclaration: public ASTNode, public AbstractVariableDeclaration {
   public:
+    FunctionParamDeclaration() : ASTNode(Node_FunctionParamDeclaration)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_FunctionParamDeclaration;
+    }
+
     /** optional */
-    unique_ptr<Expression> defaultExpression; // is ConstValueExpression
+    Expression *defaultExpression = nullptr; // is ConstValueExpression
 
     string nodeName() override {
       return "FunctionParamDeclaration";
     }
 
     AstChildRange getChildNodes() override {
-      return makeAstRange({defaultExpression.get()});
+      return makeAstRange({defaultExpression});
     }
 };
 
 class FunctionDeclaration: public ASTNode {
   public:
-    string name;
-    string typeName;
-    bool isExtern;
-    unique_ptr<LangType> returnType;
+    FunctionDeclaration() : ASTNode(Node_FunctionDeclaration)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_FunctionDeclaration;
+    }
+
+    Symbol name;
+    Symbol typeName;
+    bool isExtern = false;
+    LangType *returnType = nullptr;
     vector<FunctionParamDeclaration> arguments;
-    unique_ptr<CompoundStatement> body;
+    /** null if function is extern or its body is not parsed yet */
+    CompoundStatement *body = nullptr;
+    /** token range [begin, end) of the body when it is parsed lazily, end is 0 once the body is parsed */
+    size_t lazyBodyTokensBegin = 0;
+    size_t lazyBodyTokensEnd = 0;
 
     IRFunction *irFunction = nullptr;
     llvm::Function *llvmFunction = nullptr;
@@ -643,13 +847,20 @@ class FunctionDeclaration: public ASTNode {
       return parentClass != nullptr;
     }
 
+    /**
+     * @return true if the body was skipped by the parser and not parsed yet, see Parser::parseLazyFunctionBody()
+     */
+    bool hasUnparsedBody() const {
+      return lazyBodyTokensEnd != 0;
+    }
+
     string nodeName() override {
       return "FunctionDeclaration";
     }
 
     AstChildRange getChildNodes() override {
-      return makeAstRange({body.get()}, {
-          makeContainerIter_ValueToPtr<ASTNode>(arguments)
+      return makeAstRange({body}, {
+          makeAstContainer_ValueToPtr(arguments)
       });
     }
 };
@@ -658,11 +869,19 @@ class FunctionDeclaration: public ASTNode {
 
 class ClassDeclaration: public ASTNode {
   public:
-    string name;
-    list<unique_ptr<VariableDeclaration>> variableDeclarations;
-    unique_ptr<VariableDeclaration> thisVarDecl;
-    list<FunctionDeclaration> functionDeclarations;
-    unique_ptr<FunctionDeclaration> constructor = make_unique<FunctionDeclaration>();
+    ClassDeclaration() : ASTNode(Node_ClassDeclaration)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_ClassDeclaration;
+    }
+
+    Symbol name;
+    vector<VariableDeclaration*> variableDeclarations;
+    /** is set by the decorator */
+    VariableDeclaration *thisVarDecl = nullptr;
+    vector<FunctionDeclaration*> functionDeclarations;
+    FunctionDeclaration *constructor = nullptr;
 
     /** llvm type for this class */
     llvm::StructType *llvmStructType = nullptr;
@@ -674,9 +893,9 @@ class ClassDeclaration: public ASTNode {
     }
 
     AstChildRange getChildNodes() override {
-      return makeAstRange({constructor.get(), thisVarDecl.get()}, {
-        makeContainerIter_SmartPtrToPtr<ASTNode>(variableDeclarations),
-        makeContainerIter_ValueToPtr<ASTNode>(functionDeclarations)
+      return makeAstRange({constructor, thisVarDecl}, {
+        makeAstContainer(variableDeclarations),
+        makeAstContainer(functionDeclarations)
       });
     }
 
@@ -684,7 +903,7 @@ class ClassDeclaration: public ASTNode {
     /**
      * Find a member variable by name.
      */
-    VariableDeclaration *findMemberVariable(string &name) {
+    VariableDeclaration *findMemberVariable(const Symbol &name) {
       auto found = find_if(variableDeclarations.begin(), variableDeclarations.end(),
           [&](auto &var) {
             return var->name == name;
@@ -692,44 +911,59 @@ class ClassDeclaration: public ASTNode {
       if (found == variableDeclarations.end()) {
         return nullptr;
       }
-      return found->get();
+      return *found;
     }
 
     /**
      * Find a member function by name.
      */
-    FunctionDeclaration *findMemberFunction(string &name) {
+    FunctionDeclaration *findMemberFunction(const Symbol &name) {
       auto found = find_if(functionDeclarations.begin(), functionDeclarations.end(),
-                           [&](const FunctionDeclaration &var) {
-                             return var.name == name;
+                           [&](const FunctionDeclaration *var) {
+                             return var->name == name;
                            });
       if (found == functionDeclarations.end()) {
         return nullptr;
       }
-      return &*found;
+      return *found;
     }
 };
 
 
 /**
  * Root node of the Ast.
+ * Owns the arena of all other nodes of the ast.
  */
 class RootDeclarations: public ASTNode {
   public:
-    list<unique_ptr<VariableDeclaration>> variableDeclarations;
-    list<FunctionDeclaration> functionDeclarations;
-    list<unique_ptr<ClassDeclaration>> classDeclarations;
+    RootDeclarations() : ASTNode(Node_RootDeclarations)
+    {}
+
+    static bool classof(const ASTNode *node) {
+      return node->kind == Node_RootDeclarations;
+    }
+
+    vector<VariableDeclaration*> variableDeclarations;
+    vector<FunctionDeclaration*> functionDeclarations;
+    vector<ClassDeclaration*> classDeclarations;
     FunctionDeclaration *mainFunction = nullptr;
 
+    /** all nodes of the ast are allocated in this arena */
+    unique_ptr<AstArena> arena = make_unique<AstArena>();
+    /** owns all types of the ast */
+    unique_ptr<TypeContext> types = make_unique<TypeContext>();
+    /** tokens of the file, only kept when function bodies are parsed lazily */
+    unique_ptr<TokenBuffer> tokens;
+
     string nodeName() override {
       return "RootDeclarations";
     }
 
     AstChildRange getChildNodes() override {
       return makeAstRange({}, {
-          makeContainerIter_SmartPtrToPtr<ASTNode>(classDeclarations),
-          makeContainerIter_SmartPtrToPtr<ASTNode>(variableDeclarations),
-          makeContainerIter_ValueToPtr<ASTNode>(functionDeclarations)
+          makeAstContainer(classDeclarations),
+          makeAstContainer(variableDeclarations),
+          makeAstContainer(functionDeclarations)
       });
     }
 };
@@ -737,6 +971,55 @@ class RootDeclarations: public ASTNode {
 
 
 
+inline AbstractVariableDeclaration *AbstractVariableDeclaration::fromNode(ASTNode *node) {
+  switch (node->kind) {
+    case Node_VariableDeclaration:
+      return static_cast<VariableDeclaration*>(node);
+    case Node_FunctionParamDeclaration:
+      return static_cast<FunctionParamDeclaration*>(node);
+    default:
+      return nullptr;
+  }
+}
+
+
+
+/**
+ * Link a child node to its parent.
+ * For expressions the field of the parent that points to the child becomes the self of the child (see Replacable),
+ * thus children that are stored in a vector have to be linked after the vector is complete.
+ */
+static void linkChild(ASTNode *parent, Expression *&child) {
+  if (child) {
+    child->parentAstNode = parent;
+    child->self1 = &child;
+  }
+}
+
+static void linkChild(ASTNode *parent, Statement *&child) {
+  if (child) {
+    child->parentAstNode = parent;
+    if (auto ex = dyn_cast<Expression>(child)) {
+      ex->self2 = &child;
+    }
+  }
+}
+
+static void linkChild(ASTNode *parent, VariableExpression *&child) {
+  if (child) {
+    child->parentAstNode = parent;
+    child->self3 = &child;
+  }
+}
+
+static void linkChild(ASTNode *parent, ASTNode *child) {
+  if (child) {
+    child->parentAstNode = parent;
+  }
+}
+
+
+
 // LangTypes
 /*
 string ClassType::toString()
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <iterator>
+
+using namespace std;
+
+
+/**
+ * Owns all nodes of an ast.
+ * Nodes are bump allocated from big memory blocks and are all destroyed at once together with the arena,
+ * thus nodes link to each other via raw pointers and are never deleted individually.
+ * Nodes that are replaced stay in the arena until it is destroyed.
+ * Not thread safe, use one arena per thread.
+ */
+class AstArena
+{
+  public:
+    AstArena() = default;
+    AstArena(const AstArena &) = delete;
+    AstArena &operator=(const AstArena &) = delete;
+
+    ~AstArena() {
+      // destroy in reverse creation order, like the nodes would have been destroyed before
+      for (auto it = destructors.rbegin(); it != destructors.rend(); it++) {
+        it->destroy(it->object);
+      }
+    }
+
+    /**
+     * Create a new object (usually an ast node) in the arena.
+     * @return pointer to the new object, valid as long as the arena exists
+     */
+    template<class T, class... ARGS>
+    T *make(ARGS&&... args) {
+      void *memory = allocate(sizeof(T), alignof(T));
+      T *object = new (memory) T(forward<ARGS>(args)...);
+      // nodes still own e.g. vectors and types, thus their destructor has to be called
+      if constexpr (!is_trivially_destructible<T>::value) {
+        destructors.push_back({object, [](void *o) {
+          static_cast<T*>(o)->~T();
+        }});
+      }
+      return object;
+    }
+
+    /**
+     * Take over all objects of the other arena (e.g. nodes parsed on an other thread),
+     * they are valid as long as this arena exists. The other arena is empty afterwards.
+     */
+    void merge(AstArena &other) {
+      blocks.insert(blocks.end(), make_move_iterator(other.blocks.begin()), make_move_iterator(other.blocks.end()));
+      destructors.insert(destructors.end(), other.destructors.begin(), other.destructors.end());
+      usedBytes += other.usedBytes;
+      other.blocks.clear();
+      other.destructors.clear();
+      other.blockPos = nullptr;
+      other.blockRemaining = 0;
+      other.usedBytes = 0;
+    }
+
+    /**
+     * Amount of bytes used by objects in the arena.
+     */
+    size_t bytesUsed() const {
+      return usedBytes;
+    }
+
+  private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    struct Destructor {
+        void *object;
+        void (*destroy)(void*);
+    };
+
+    vector<unique_ptr<char[]>> blocks;
+    char *blockPos = nullptr;
+    size_t blockRemaining = 0;
+    size_t usedBytes = 0;
+    vector<Destructor> destructors;
+
+    void *allocate(size_t size, size_t alignment) {
+      size_t padding = (alignment - reinterpret_cast<uintptr_t>(blockPos) % alignment) % alignment;
+      if (!blockPos || padding + size > blockRemaining) {
+        // objects bigger than a block get their own block
+        size_t newBlockSize = max(BLOCK_SIZE, size + alignment);
+        blocks.emplace_back(new char[newBlockSize]); // not zero initialized
+        blockPos = blocks.back().get();
+        blockRemaining = newBlockSize;
+        padding = (alignment - reinterpret_cast<uintptr_t>(blockPos) % alignment) % alignment;
+      }
+      void *memory = blockPos + padding;
+      blockPos += padding + size;
+      blockRemaining -= padding + size;
+      usedBytes += size;
+      return memory;
+    }
+};
@@ -35,54 +35,55 @@ void replaceNode(T *toReplace, unique_ptr<T> replaceWith) {
 
 /**
  * A AstNode can extend this class to provide replacement functionality.
- * Then the SetAstNodeParentAndSelfPass has also to be adapted to set the self pointers of this ast node.
+ * Then the Parser (see linkChild in AST.h) has also to be adapted to set the self pointers of this ast node.
  * @tparam T type of the node
- * @tparam SELF1 node can be stored in unique_ptr<SELF1>
- * @tparam SELF2 node can be stored in unique_ptr<SELF2>
- * @tparam SELF3 node can be stored in unique_ptr<SELF3>
+ * @tparam SELF1 node can be linked by SELF1*
+ * @tparam SELF2 node can be linked by SELF2*
+ * @tparam SELF3 node can be linked by SELF3*
  */
 template<class T, class SELF1, class SELF2, class SELF3>
 class Replacable {
   public:
-    unique_ptr<SELF1> *self1 = nullptr;
-    unique_ptr<SELF2> *self2 = nullptr;
-    unique_ptr<SELF3> *self3 = nullptr;
+    SELF1 **self1 = nullptr;
+    SELF2 **self2 = nullptr;
+    SELF3 **self3 = nullptr;
 
 
     /**
      * Replace node this node with replaceWith.
-     * Afterwards the original pointer to this node will be invalid.
+     * Afterwards the parent links to the new node, the old node stays in the AstArena until the ast is destroyed.
      * All properties of the newNode 'replaceWith' have to be set manually except its self props.
      * @tparam NEW type of the new node
-     * @param replaceWith replace 'this' with this node
+     * @param replaceWith replace 'this' with this node, has to be allocated in the same AstArena
      * @throws runtime_error when node could not be replaced because self props were not assigned to this node
+     *                       or the self prop that is assigned can not point to the new node
      * @return pointer to the new node that replaced the old one
      */
-    template<class NEW>//, enable_if_t<is_base_of<T, NEW>::value>>
-    //using NEW = T;
-    NEW *replaceNode(unique_ptr<NEW> replaceWith) {
-      //T *nodeOld = replaceWith.get();
-      //ASTNode *nodeAstNew = nullptr;
-      NEW *newNode = replaceWith.get();
-
+    template<class NEW>
+    NEW *replaceNode(NEW *replaceWith) {
       // replace self that is not null with 'replaceWith'
       if (self1) {
-        newNode->self1 = this->self1; // set self of new node to self of old node
-        // @todo better use self1.swap(replaceWith)
-        *(self1) = move(replaceWith); // replace old with new
+        replaceWith->self1 = this->self1; // set self of new node to self of old node
+        *(self1) = replaceWith; // replace old with new
       }
       else if (self2) {
-        newNode->self2 = this->self2; // set self of new node to self of old node
-        *(self2) = move(replaceWith); // replace old with new
+        replaceWith->self2 = this->self2; // set self of new node to self of old node
+        *(self2) = replaceWith; // replace old with new
       }
       else if (self3) {
-        newNode->self3 = this->self3; // set self of new node to self of old node
-        *(self3) = move(replaceWith); // replace old with new
+        // only a node that is also a SELF3 can be linked by self3
+        if constexpr (is_convertible<NEW*, SELF3*>::value) {
+          replaceWith->self3 = this->self3; // set self of new node to self of old node
+          *(self3) = replaceWith; // replace old with new
+        }
+        else {
+          throw runtime_error(string("replaceNode for ") + typeid(T).name() + ": node is linked by self3, the new node can not be linked by it");
+        }
       }
       else {
         throwAllSelfNull<T>();
       }
-      return newNode;
+      return replaceWith;
     }
 
     bool selfSet() {
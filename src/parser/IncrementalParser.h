@@ -0,0 +1,416 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <unordered_map>
+#include "Parser.h"
+#include "lexer/Lexer.h"
+#include "SourceManager.h"
+
+using namespace std;
+
+
+/**
+ * Change of the source text: removedLength chars at offset are replaced by insertedText.
+ */
+struct TextEdit {
+    uint32_t offset = 0;
+    uint32_t removedLength = 0;
+    string insertedText;
+};
+
+
+/**
+ * Keeps the ast of a source text up to date while the text is edited (e.g. in an editor or watch mode).
+ * For each edit only the global declarations touched by the edit are lexed and parsed again,
+ * all other declarations and their nodes are kept.
+ * The edited region is only reparsed alone when lexing it ends exactly at the start of the next unchanged declaration,
+ * otherwise (e.g. when the edit opens a comment or string) the whole text is parsed again.
+ *
+ * The locations of the nodes are not moved by edits, thus an edit costs the same wherever it is in the text.
+ * Instead the nodes of each global declaration get their own range of virtual offsets,
+ * the parser registers itself as offset map of the source manager to resolve them to offsets in the current text.
+ *
+ * The ast is not decorated, it has to be decorated again after edits.
+ * Replaced nodes stay in the arena of the root, when it grows too much the whole text is parsed again.
+ */
+class IncrementalParser : public SourceOffsetMap
+{
+  public:
+    /**
+     * Parse the whole text.
+     * @throws ParseException when an error occurs while parsing, or the exception of the lexer
+     * @throws length_error when the text is too large for virtual offsets
+     */
+    explicit IncrementalParser(string text) : text(move(text))
+    {
+      reparseAll();
+      sourceManager.setOffsetMap(this);
+    }
+
+    ~IncrementalParser() override {
+      if (sourceManager.getOffsetMap() == this) {
+        sourceManager.setOffsetMap(nullptr);
+      }
+    }
+
+    // registered as offset map by its address
+    IncrementalParser(const IncrementalParser &) = delete;
+    IncrementalParser &operator=(const IncrementalParser &) = delete;
+
+    /**
+     * Apply the edit to the text and reparse the affected global declarations.
+     * When lexing or parsing fails the text is still changed, the ast stays as it was before the edit
+     * and the whole text is parsed again at the next edit.
+     * @throws ParseException when an error occurs while parsing, or the exception of the lexer
+     * @throws out_of_range when the removed range is not within the text
+     */
+    void applyEdit(const TextEdit &edit) {
+      if (edit.offset > text.size() || edit.removedLength > text.size() - edit.offset) {
+        throw out_of_range("edit at " + to_string(edit.offset) + " removes " + to_string(edit.removedLength)
+                           + " chars but text has only " + to_string(text.size()) + " chars");
+      }
+
+      // declarations touched by the edit: [firstIndex, lastIndex)
+      uint32_t editEnd = edit.offset + edit.removedLength;
+      auto first = partition_point(declarations.begin(), declarations.end(), [&](const unique_ptr<Declaration> &decl) {
+        return decl->end < edit.offset;
+      });
+      auto last = partition_point(first, declarations.end(), [&](const unique_ptr<Declaration> &decl) {
+        return decl->begin <= editEnd;
+      });
+      size_t firstIndex = first - declarations.begin();
+      size_t lastIndex = last - declarations.begin();
+
+      // the region to reparse also contains the space to the neighbour declarations
+      uint32_t regionBegin = firstIndex > 0 ? declarations[firstIndex - 1]->end : 0;
+      uint32_t regionEnd = lastIndex < declarations.size() ? declarations[lastIndex]->begin : text.size();
+      int64_t shift = (int64_t) edit.insertedText.size() - edit.removedLength;
+      uint32_t newRegionEnd = regionEnd + shift;
+
+      text.replace(edit.offset, edit.removedLength, edit.insertedText);
+      bool virtualOffsetsLeft = newRegionEnd - regionBegin < UINT32_MAX - nextVirtualOffset;
+      if (needsReparseAll || !virtualOffsetsLeft || root.arena->bytesUsed() > MAX_ARENA_GROWTH * arenaBytesAfterReparseAll) {
+        reparseAll();
+        return;
+      }
+
+      RootDeclarations parsed;
+      vector<GlobalDeclarationRange> ranges;
+      try {
+        TokenBuffer tokens(text);
+        if (!lexRegion(regionBegin, newRegionEnd, tokens)) {
+          reparseAll();
+          return;
+        }
+        ranges = Parser(move(tokens)).parseGlobalDeclarationsInto(parsed, *root.arena);
+      }
+      catch (exception &e) {
+        needsReparseAll = true;
+        throw;
+      }
+
+      // the new nodes get the next unused virtual offsets
+      int64_t virtualShift = (int64_t) nextVirtualOffset - regionBegin;
+      nextVirtualOffset += newRegionEnd - regionBegin + 1;
+      vector<unique_ptr<Declaration>> newDeclarations;
+      bool sameKinds = ranges.size() == lastIndex - firstIndex;
+      for (size_t i = 0; i < ranges.size(); i++) {
+        shiftLocations(ranges[i].declaration, virtualShift);
+        newDeclarations.push_back(makeDeclaration(ranges[i], virtualShift));
+        sameKinds = sameKinds && ranges[i].declaration->kind == declarations[firstIndex + i]->node->kind;
+      }
+
+      // the following declarations are moved by the edit, their nodes keep their virtual offsets
+      for (size_t i = lastIndex; i < declarations.size(); i++) {
+        declarations[i]->begin += shift;
+        declarations[i]->end += shift;
+      }
+
+      // replace the touched declarations
+      for (size_t i = firstIndex; i < lastIndex; i++) {
+        unregisterDeclaration(*declarations[i]);
+      }
+      for (auto &decl : newDeclarations) {
+        registerDeclaration(*decl);
+      }
+      if (newDeclarations.size() == lastIndex - firstIndex) {
+        for (size_t i = 0; i < newDeclarations.size(); i++) {
+          newDeclarations[i]->listIndex = declarations[firstIndex + i]->listIndex;
+          declarations[firstIndex + i] = move(newDeclarations[i]);
+        }
+      }
+      else {
+        declarations.erase(declarations.begin() + firstIndex, declarations.begin() + lastIndex);
+        declarations.insert(declarations.begin() + firstIndex, make_move_iterator(newDeclarations.begin()), make_move_iterator(newDeclarations.end()));
+      }
+
+      if (sameKinds) {
+        for (size_t i = firstIndex; i < lastIndex; i++) {
+          setRootDeclaration(*declarations[i]);
+        }
+      }
+      else {
+        updateRootDeclarations();
+      }
+    }
+
+    /**
+     * The ast of the current text.
+     * The locations of its nodes are resolved to the current text by the source manager, see SourceOffsetMap.
+     */
+    RootDeclarations &getRoot() {
+      return root;
+    }
+
+    const string &getText() const {
+      return text;
+    }
+
+    /**
+     * Amount of times the whole text has been parsed, afterwards all nodes of the ast are new.
+     */
+    size_t getFullParsesCount() const {
+      return fullParsesCount;
+    }
+
+    /**
+     * Map a offset of a node location to the offset in the current text.
+     * Offsets below VIRTUAL_OFFSETS_BEGIN are no virtual offsets and stay the same.
+     */
+    uint32_t toSourceOffset(uint32_t offset) const override {
+      if (offset < VIRTUAL_OFFSETS_BEGIN) {
+        return offset;
+      }
+      // the declaration with the last virtual begin <= offset
+      auto found = declarationsByVirtualBegin.upper_bound(offset);
+      if (found == declarationsByVirtualBegin.begin()) {
+        return offset;
+      }
+      const Declaration &decl = *prev(found)->second;
+      return decl.begin + (offset - decl.virtualBegin);
+    }
+
+    /**
+     * Parse the given global declarations of the current ast again from their unchanged text,
+     * e.g. to get undecorated nodes of them. The ast itself is not changed.
+     * The new nodes have the virtual offsets of the declaration they are parsed from.
+     * @return the new nodes in the order of the given declarations
+     * @throws out_of_range when a node is not a global declaration of the current ast
+     */
+    vector<ASTNode*> reparseDeclarations(const vector<ASTNode*> &nodes) {
+      vector<ASTNode*> reparsed;
+      reparsed.reserve(nodes.size());
+      for (auto node : nodes) {
+        auto found = declarationOfNode.find(node);
+        if (found == declarationOfNode.end()) {
+          throw out_of_range("node to reparse is not a global declaration of the ast");
+        }
+        const Declaration &decl = *found->second;
+        TokenBuffer tokens(text);
+        Lexer lexer(text, decl.begin, decl.end);
+        for (Token token = lexer.getNextToken(); token.type != EndOfFile; token = lexer.getNextToken()) {
+          if (token.type != Comment) {
+            tokens.push_back(token);
+          }
+        }
+        tokens.push_back(Token(EndOfFile, SrcLocationRange(decl.end)));
+
+        // the text did not change since it was parsed, thus it is exactly one declaration again
+        RootDeclarations parsed;
+        auto ranges = Parser(move(tokens)).parseGlobalDeclarationsInto(parsed, *root.arena);
+        ASTNode *declaration = ranges.front().declaration;
+        shiftLocations(declaration, (int64_t) decl.virtualBegin - decl.begin);
+        declaration->parentAstNode = &root;
+        reparsed.push_back(declaration);
+      }
+      return reparsed;
+    }
+
+    /**
+     * Replace global declarations of the ast by other nodes at the same place,
+     * the replacements need to have the virtual offsets of the replaced declarations (see reparseDeclarations()).
+     * @param replacements maps each declaration to its replacement
+     */
+    void replaceDeclarations(const unordered_map<ASTNode*, ASTNode*> &replacements) {
+      vector<pair<Declaration*, ASTNode*>> replaced;
+      for (auto &[node, replacement] : replacements) {
+        auto found = declarationOfNode.find(node);
+        if (found != declarationOfNode.end()) {
+          replaced.emplace_back(found->second, replacement);
+        }
+      }
+
+      bool sameKinds = true;
+      for (auto &[decl, replacement] : replaced) {
+        sameKinds = sameKinds && replacement->kind == decl->node->kind;
+        declarationOfNode.erase(decl->node);
+        decl->node = replacement;
+        declarationOfNode[replacement] = decl;
+      }
+      if (sameKinds) {
+        for (auto &[decl, replacement] : replaced) {
+          setRootDeclaration(*decl);
+        }
+      }
+      else {
+        updateRootDeclarations();
+      }
+    }
+
+  private:
+    /** when the arena exceeds this factor of its size after parsing the whole text, the whole text is parsed again */
+    static constexpr size_t MAX_ARENA_GROWTH = 4;
+    /** virtual offsets start here, thus they differ from offsets in the text */
+    static constexpr uint32_t VIRTUAL_OFFSETS_BEGIN = 0x80000000;
+
+    /**
+     * A global declaration with its source range [begin, end) from its first to its last token.
+     * The locations of its nodes are virtual offsets, virtualBegin is the virtual offset of begin.
+     */
+    struct Declaration {
+        ASTNode *node;
+        uint32_t begin;
+        uint32_t end;
+        uint32_t virtualBegin;
+        /** index in the declaration list of the root for the kind of the node */
+        size_t listIndex = 0;
+    };
+
+    string text;
+    RootDeclarations root;
+    /** all global declarations in source order */
+    vector<unique_ptr<Declaration>> declarations;
+    unordered_map<ASTNode*, Declaration*> declarationOfNode;
+    map<uint32_t, Declaration*> declarationsByVirtualBegin;
+    /** start of the virtual offsets not given to nodes yet */
+    uint32_t nextVirtualOffset = VIRTUAL_OFFSETS_BEGIN;
+    bool needsReparseAll = false;
+    size_t arenaBytesAfterReparseAll = 0;
+    size_t fullParsesCount = 0;
+
+
+    void reparseAll() {
+      RootDeclarations newRoot;
+      RootDeclarations parsed;
+      vector<GlobalDeclarationRange> ranges;
+      try {
+        if (text.size() >= VIRTUAL_OFFSETS_BEGIN) {
+          throw length_error("text of " + to_string(text.size()) + " chars is too large for incremental parsing");
+        }
+        ranges = Parser(Lexer(text).getAllTokens()).parseGlobalDeclarationsInto(parsed, *newRoot.arena);
+      }
+      catch (exception &e) {
+        needsReparseAll = true;
+        throw;
+      }
+      needsReparseAll = false;
+      fullParsesCount++;
+
+      root = move(newRoot);
+      root.location = SrcLocationRange(0);
+      declarations.clear();
+      declarationOfNode.clear();
+      declarationsByVirtualBegin.clear();
+      for (auto &range : ranges) {
+        shiftLocations(range.declaration, VIRTUAL_OFFSETS_BEGIN);
+        declarations.push_back(makeDeclaration(range, VIRTUAL_OFFSETS_BEGIN));
+        registerDeclaration(*declarations.back());
+      }
+      nextVirtualOffset = VIRTUAL_OFFSETS_BEGIN + text.size() + 1;
+      updateRootDeclarations();
+      arenaBytesAfterReparseAll = max<size_t>(root.arena->bytesUsed(), 1);
+    }
+
+    static unique_ptr<Declaration> makeDeclaration(const GlobalDeclarationRange &range, int64_t virtualShift) {
+      uint32_t begin = range.location.offset;
+      return make_unique<Declaration>(Declaration{range.declaration, begin, begin + range.location.length, (uint32_t) (begin + virtualShift)});
+    }
+
+    void registerDeclaration(Declaration &decl) {
+      declarationOfNode[decl.node] = &decl;
+      declarationsByVirtualBegin[decl.virtualBegin] = &decl;
+    }
+
+    void unregisterDeclaration(const Declaration &decl) {
+      declarationOfNode.erase(decl.node);
+      declarationsByVirtualBegin.erase(decl.virtualBegin);
+    }
+
+    /**
+     * Lex the text from begin until end into tokens.
+     * @return false if the last token does not end before end and the next token does not start exactly at end,
+     *         then the tokens after end differ from the tokens before the edit
+     */
+    bool lexRegion(uint32_t begin, uint32_t end, TokenBuffer &tokens) {
+      Lexer lexer(text, begin, text.size());
+      Token token = lexer.getNextToken();
+      for (; token.type != EndOfFile && token.location.offset < end; token = lexer.getNextToken()) {
+        // ignore comments
+        if (token.type != Comment) {
+          tokens.push_back(token);
+        }
+      }
+      // the EndOfFile token is located at the end of the text
+      if (token.location.offset != end) {
+        return false;
+      }
+      tokens.push_back(Token(EndOfFile, SrcLocationRange(end)));
+      return true;
+    }
+
+    /**
+     * Fill the declaration lists of the root in source order.
+     */
+    void updateRootDeclarations() {
+      root.variableDeclarations.clear();
+      root.functionDeclarations.clear();
+      root.classDeclarations.clear();
+      for (auto &decl : declarations) {
+        decl->node->parentAstNode = &root;
+        if (auto var = dyn_cast<VariableDeclaration>(decl->node)) {
+          decl->listIndex = root.variableDeclarations.size();
+          root.variableDeclarations.push_back(var);
+        }
+        else if (auto func = dyn_cast<FunctionDeclaration>(decl->node)) {
+          decl->listIndex = root.functionDeclarations.size();
+          root.functionDeclarations.push_back(func);
+        }
+        else {
+          decl->listIndex = root.classDeclarations.size();
+          root.classDeclarations.push_back(cast<ClassDeclaration>(decl->node));
+        }
+      }
+    }
+
+    /**
+     * Put the node of the declaration at its index into the root list of its kind,
+     * it has to replace a node of the same kind.
+     */
+    void setRootDeclaration(Declaration &decl) {
+      decl.node->parentAstNode = &root;
+      if (auto var = dyn_cast<VariableDeclaration>(decl.node)) {
+        root.variableDeclarations[decl.listIndex] = var;
+      }
+      else if (auto func = dyn_cast<FunctionDeclaration>(decl.node)) {
+        root.functionDeclarations[decl.listIndex] = func;
+      }
+      else {
+        root.classDeclarations[decl.listIndex] = cast<ClassDeclaration>(decl.node);
+      }
+    }
+
+    static void shiftLocations(ASTNode *node, int64_t shift) {
+      if (node->location.isValid()) {
+        node->location.offset += shift;
+      }
+      for (auto child : node->getChildNodes()) {
+        shiftLocations(child, shift);
+      }
+    }
+};
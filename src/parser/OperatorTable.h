@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "AST.h"
+
+using namespace std;
+
+
+/**
+ * How a token behaves as binary operator.
+ */
+struct BinaryOperatorInfo {
+    BinaryExpressionOp operation = Expr_Op_Invalid;
+    /** 0 if the token is no binary operator, operators with higher binding power bind stronger */
+    uint8_t bindingPower = 0;
+};
+
+/**
+ * Binding powers of all binary operators, all of them are left associative.
+ */
+constexpr array<BinaryOperatorInfo, EndOfFile + 1> makeBinaryOperatorTable() {
+  array<BinaryOperatorInfo, EndOfFile + 1> table{};
+  table[Operator_LogicOr]          = {EXPR_OP_LOGIC_OR, 1};
+  table[Operator_LogicAnd]         = {EXPR_OP_LOGIC_AND, 2};
+  table[Operator_Equals]           = {EXPR_OP_EQUALS, 3};
+  table[Operator_NotEquals]        = {EXPR_OP_NOT_EQUALS, 3};
+  table[Operator_GreaterThen]      = {EXPR_OP_GREATER_THEN, 4};
+  table[Operator_GreaterEqualThen] = {EXPR_OP_GREATER_EQUALS_THEN, 4};
+  table[Operator_LessThen]         = {EXPR_OP_LESS_THEN, 4};
+  table[Operator_LessEqualThen]    = {EXPR_OP_LESS_EQUALS_THEN, 4};
+  table[Operator_Plus]             = {Expr_Op_Plus, 5};
+  table[Operator_Minus]            = {Expr_Op_Minus, 5};
+  table[Operator_Multiply]         = {Expr_Op_Multiply, 6};
+  table[Operator_Divide]           = {Expr_Op_Divide, 6};
+  return table;
+}
+
+constexpr array<BinaryOperatorInfo, EndOfFile + 1> binaryOperatorTable = makeBinaryOperatorTable();
+
+static_assert(binaryOperatorTable[Operator_Multiply].bindingPower > binaryOperatorTable[Operator_Plus].bindingPower);
+static_assert(binaryOperatorTable[Identifier].operation == Expr_Op_Invalid);
+
+
+/**
+ * Get the binary operator for a token type.
+ * For tokens that are no binary operator the operation is Expr_Op_Invalid and the binding power 0.
+ */
+static const BinaryOperatorInfo &getBinaryOperator(TOKEN_TYPE type) {
+  return binaryOperatorTable[type];
+}
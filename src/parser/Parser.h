@@ -3,26 +3,74 @@
 #include <iostream>
 #include "exceptions.h"
 #include "AST.h"
+#include "OperatorTable.h"
 #include "util/util.h"
-#include "SetAstNodeParentAndSelfPass.h"
+#include "util/Parallel.h"
+#include "lexer/TokenStream.h"
 
 using namespace std;
 
 
+/**
+ * A parsed global declaration and its source range from its first to its last token.
+ */
+struct GlobalDeclarationRange {
+    ASTNode *declaration;
+    SrcLocationRange location;
+};
+
+
 /*
  * Parser class
  */
 class Parser
 {
   private:
-    list<Token> tokens;
-    using TokenIterator = list<Token>::iterator;
-    TokenIterator tokenIter = tokens.begin();
+    TokenStream tokens;
+    /** arena of the ast that is currently parsed */
+    AstArena *arena = nullptr;
+    /** skip bodies of global functions, see setLazyFunctionBodies() */
+    bool lazyFunctionBodies = false;
 
   public:
-    explicit Parser(list<Token> &&tokens) : tokens(move(tokens))
+    explicit Parser(TokenBuffer &&tokens) : tokens(move(tokens))
+    {}
+
+    /**
+     * @param tokens use TokenStream(lexer) to parse while lexing
+     */
+    explicit Parser(TokenStream &&tokens) : tokens(move(tokens))
     {}
 
+    /**
+     * When enabled the bodies of global functions are skipped and only their token range is saved,
+     * the root keeps the tokens and a body is parsed via parseLazyFunctionBody() when it is needed.
+     * Has no effect when the tokens are streamed, then tokens can't be revisited.
+     */
+    void setLazyFunctionBodies(bool lazy) {
+      lazyFunctionBodies = lazy;
+    }
+
+    /**
+     * Parse the skipped body of a function when function bodies are parsed lazily.
+     * Does nothing if the body is already parsed.
+     * @throws ParseException when an error occurs while parsing the body
+     */
+    static void parseLazyFunctionBody(RootDeclarations &root, FunctionDeclaration *func) {
+      if (!func->hasUnparsedBody()) {
+        return;
+      }
+      // mark as parsed before parsing, thus a body with errors is not parsed again
+      size_t begin = func->lazyBodyTokensBegin;
+      size_t end = func->lazyBodyTokensEnd;
+      func->lazyBodyTokensEnd = 0;
+
+      Parser bodyParser(TokenStream(*root.tokens, begin, end));
+      bodyParser.arena = root.arena.get();
+      func->body = bodyParser.parseCompoundStatement();
+      linkChild(func, func->body);
+    }
+
 
     /**
      * Parse a whole file with the tokens of this file.
@@ -35,54 +83,202 @@ class Parser
       }
 
       RootDeclarations root;
-      root.location = tokens.begin()->location;
+      root.location = tokens.getLocation();
+      arena = root.arena.get();
 
       // for all global declarations
-      // this can be:
-      // - a global variable declaration
-      // - a global function declaration
-      tokenIter = tokens.begin();
       while (!tokensEmpty()) {
-        // check type of declaration
-        if (isVariableDeclaration()) {
-          root.variableDeclarations.push_back(parseVariableDeclaration());
-        }
-        else if (isFunctionDeclaration()) {
-          root.functionDeclarations.push_back(parseFunctionDeclaration());
-        }
-        else if (getTokenType() == Keyword_class) {
-          root.classDeclarations.push_back(parseClassDeclaration());
-        }
-        else {
-          throw ParseException("got unexpected token " + toString(tokenIter->type), *tokenIter);
-        }
+        parseGlobalDeclaration(root);
       }
       consumeToken(EndOfFile);
 
-      // set parents of all nodes
-      SetAstNodeParentAndSelfPass nodeParentAndSelfPass;
-      nodeParentAndSelfPass.run(root);
+      // keep tokens for parsing the skipped function bodies later
+      if (isLazyParsing()) {
+        root.tokens = make_unique<TokenBuffer>(tokens.releaseTokens());
+      }
+
+      linkGlobalDeclarations(root);
+      return root;
+    }
+
+
+
+    /**
+     * Parse a whole file like parse(), but the global declarations are parsed on multiple threads.
+     * A prepass over the token types splits the tokens at global declarations into chunks of similar size,
+     * each chunk is parsed into its own arena and the declarations are joined in source order.
+     * Falls back to parse() for small files and when the tokens are streamed.
+     * @throws ParseException of the first error (in source order) of the chunks
+     */
+    RootDeclarations parseParallel(unsigned threadsCount = getWorkerThreadsCount()) {
+      if (tokens.isStreaming() || tokens.empty()) {
+        return parse();
+      }
+      const TokenBuffer &buffer = tokens.getBuffer();
+      size_t chunksCount = max<size_t>(1, min<size_t>(threadsCount, buffer.size() / MIN_CHUNK_TOKENS));
+      if (chunksCount == 1) {
+        return parse();
+      }
+
+      vector<size_t> boundaries = findChunkBoundaries(buffer, chunksCount);
+      vector<RootDeclarations> chunkRoots(boundaries.size() - 1);
+      parallelFor(chunkRoots.size(), [&](size_t chunk) {
+        Parser chunkParser(TokenStream(buffer, boundaries[chunk], boundaries[chunk + 1]));
+        chunkParser.lazyFunctionBodies = lazyFunctionBodies;
+        chunkParser.arena = chunkRoots[chunk].arena.get();
+        while (!chunkParser.tokensEmpty()) {
+          chunkParser.parseGlobalDeclaration(chunkRoots[chunk]);
+        }
+      }, threadsCount);
+
+      // join
+      RootDeclarations root;
+      root.location = buffer.getLocation(0);
+      for (auto &chunkRoot : chunkRoots) {
+        root.arena->merge(*chunkRoot.arena);
+        root.variableDeclarations.insert(root.variableDeclarations.end(), chunkRoot.variableDeclarations.begin(), chunkRoot.variableDeclarations.end());
+        root.functionDeclarations.insert(root.functionDeclarations.end(), chunkRoot.functionDeclarations.begin(), chunkRoot.functionDeclarations.end());
+        root.classDeclarations.insert(root.classDeclarations.end(), chunkRoot.classDeclarations.begin(), chunkRoot.classDeclarations.end());
+      }
+
+      // keep tokens for parsing the skipped function bodies later
+      if (isLazyParsing()) {
+        root.tokens = make_unique<TokenBuffer>(tokens.releaseTokens());
+      }
 
+      linkGlobalDeclarations(root);
       return root;
     }
 
 
 
+    /**
+     * Parse all global declarations of the tokens like parse(), but add them to the given declarations
+     * and create their nodes in the given arena, thus a part of a file can be reparsed into an existing ast.
+     * The tokens must not be streamed and end with an EndOfFile token.
+     * @return the parsed declarations with their source ranges in source order
+     * @throws ParseException when an error occurs while parsing
+     */
+    vector<GlobalDeclarationRange> parseGlobalDeclarationsInto(RootDeclarations &declarations, AstArena &nodesArena) {
+      arena = &nodesArena;
+      vector<GlobalDeclarationRange> ranges;
+      while (!tokensEmpty()) {
+        uint32_t begin = getTokenLocation().offset;
+        size_t variablesCount = declarations.variableDeclarations.size();
+        size_t functionsCount = declarations.functionDeclarations.size();
+        parseGlobalDeclaration(declarations);
+
+        const SrcLocationRange &last = tokens.getBuffer().getLocation(tokens.getIndex() - 1);
+        ASTNode *declaration = declarations.variableDeclarations.size() > variablesCount ? (ASTNode*) declarations.variableDeclarations.back()
+                             : declarations.functionDeclarations.size() > functionsCount ? (ASTNode*) declarations.functionDeclarations.back()
+                             : (ASTNode*) declarations.classDeclarations.back();
+        ranges.push_back({declaration, SrcLocationRange(begin, last.offset + last.length - begin)});
+      }
+      consumeToken(EndOfFile);
+      return ranges;
+    }
+
+
+
   private:
+    /** files with less tokens are not parsed in parallel */
+    static constexpr size_t MIN_CHUNK_TOKENS = 64 * 1024;
+
+    /**
+     * Find token indices to split the tokens into about chunksCount chunks of similar size.
+     * Chunks start at a global declaration, that is a 'let', 'fun' or 'class' token outside of any braces.
+     * @return indices of the chunk starts followed by the tokens count
+     */
+    static vector<size_t> findChunkBoundaries(const TokenBuffer &buffer, size_t chunksCount) {
+      size_t size = buffer.size();
+      size_t chunkSize = size / chunksCount;
+
+      vector<size_t> boundaries = {0};
+      size_t nextSplit = chunkSize;
+      int depth = 0;
+      for (size_t i = 0; i < size && boundaries.size() < chunksCount; i++) {
+        switch (buffer.getType(i)) {
+          case LeftBrace:
+            depth++;
+            break;
+          case RightBrace:
+            depth--;
+            break;
+          case Keyword_let:
+          case Keyword_fun:
+          case Keyword_class:
+            if (depth <= 0 && i >= nextSplit) {
+              boundaries.push_back(i);
+              nextSplit = i + chunkSize;
+            }
+            break;
+          default:
+            break;
+        }
+      }
+      boundaries.push_back(size);
+      return boundaries;
+    }
+
+    /**
+     * Parse one global declaration and add it to root, this can be:
+     * - a global variable declaration
+     * - a global function declaration
+     * - a class declaration
+     */
+    void parseGlobalDeclaration(RootDeclarations &root) {
+      // check type of declaration
+      if (isVariableDeclaration()) {
+        root.variableDeclarations.push_back(parseVariableDeclaration());
+      }
+      else if (isFunctionDeclaration()) {
+        root.functionDeclarations.push_back(parseFunctionDeclaration());
+      }
+      else if (getTokenType() == Keyword_class) {
+        root.classDeclarations.push_back(parseClassDeclaration());
+      }
+      else {
+        throw ParseException("got unexpected token " + toString(getTokenType()), getToken());
+      }
+    }
+
+    /**
+     * Set the parent of the global declarations, all other nodes are linked to their parent while parsing.
+     */
+    static void linkGlobalDeclarations(RootDeclarations &root) {
+      for (auto decl : root.classDeclarations) {
+        decl->parentAstNode = &root;
+      }
+      for (auto decl : root.variableDeclarations) {
+        decl->parentAstNode = &root;
+      }
+      for (auto decl : root.functionDeclarations) {
+        decl->parentAstNode = &root;
+      }
+    }
+
+    /**
+     * Create a new node in the arena of the ast.
+     */
+    template<class T, class... ARGS>
+    T *makeNode(ARGS&&... args) {
+      return arena->make<T>(forward<ARGS>(args)...);
+    }
+
     /**
      * Consume next expected token.
      * If next token not matches given expected token type, a exception is thrown.
      * @param type the type of next token has to match this type
-     * @return iterator to consumed token
+     * @return the consumed token
      */
-    TokenIterator consumeToken(TOKEN_TYPE type) {
-      if (tokenIter != tokens.end()) {
-        if (tokenIter->type == type) {
-          TokenIterator iterOld = tokenIter;
-          tokenIter++;
-          return iterOld;
+    Token consumeToken(TOKEN_TYPE type) {
+      if (!tokens.atEnd()) {
+        if (tokens.getType() == type) {
+          Token token = tokens.getToken();
+          tokens.next();
+          return token;
         } else {
-          throw ParseException("expected token " + toString(type) + " but got token " + toString(tokenIter->type), *tokenIter);
+          throw ParseException("expected token " + toString(type) + " but got token " + toString(getTokenType()), getToken());
         }
       }
       else {
@@ -98,12 +294,19 @@ class Parser
      * If next token not matches given expected token type, a exception is thrown.
      * @param type the type of next token has to match this type
      * @param applyLocationTo sets the location of this ast node to the consumed tokens location
-     * @return iterator to consumed token
+     * @return the consumed token
+     */
+    Token consumeToken(TOKEN_TYPE type, ASTNode &applyLocationTo) {
+      auto token = consumeToken(type);
+      applyLocationTo.location = token.location;
+      return token;
+    }
+
+    /**
+     * Get the next token that can be consumed.
      */
-    TokenIterator consumeToken(TOKEN_TYPE type, ASTNode &applyLocationTo) {
-      auto iter = consumeToken(type);
-      applyLocationTo.location = iter->location;
-      return iter;
+    Token getToken() {
+      return tokens.getToken();
     }
 
     /**
@@ -112,14 +315,14 @@ class Parser
      *                           ^^^ return type of this
      */
     TOKEN_TYPE getTokenType() {
-      return tokenIter->type;
+      return tokens.getType();
     }
 
     /**
      * Get token source location of the next token that can be consumed.
      */
     SrcLocationRange getTokenLocation() {
-      return tokenIter->location;
+      return tokens.getLocation();
     }
 
     /**
@@ -128,45 +331,66 @@ class Parser
      *                                           ^^^ return type of this
      */
     TOKEN_TYPE getNextTokenType() {
-      if (tokenIter == tokens.end()) {
-        return EndOfFile;
-      }
-      else {
-        return next(tokenIter)->type;
-      }
+      return tokens.getType(1);
     }
 
     /**
      * Return true if there is no token left for parsing
      */
     bool tokensEmpty() {
-      return tokenIter == tokens.end() || getTokenType() == EndOfFile;
+      return tokens.atEnd() || getTokenType() == EndOfFile;
     }
 
     void throwUnexpectedTokenException(const vector<TOKEN_TYPE>& expectedTokens, string phaseText = "") {
       string preText = phaseText.empty() ? "" : phaseText + " ";
       if (expectedTokens.empty()) {
-        throw ParseException(preText + "got unexpected token " + toString(tokenIter->type), *tokenIter);
+        throw ParseException(preText + "got unexpected token " + toString(getTokenType()), getToken());
       }
       else if (expectedTokens.size() == 1) {
-        throw ParseException(preText + "expected " + toString(expectedTokens[0]) + " but got token " + toString(tokenIter->type), *tokenIter);
+        throw ParseException(preText + "expected " + toString(expectedTokens[0]) + " but got token " + toString(getTokenType()), getToken());
       }
       else {
-        throw ParseException(preText + "expected one of " + toString(expectedTokens) + " but got token " + toString(tokenIter->type), *tokenIter);
+        throw ParseException(preText + "expected one of " + toString(expectedTokens) + " but got token " + toString(getTokenType()), getToken());
       }
     }
 
     void throwUnexpectedTokenExceptionStr(string expected) {
-      throw ParseException("expected " + expected + " but got token " + toString(tokenIter->type), *tokenIter);
+      throw ParseException("expected " + expected + " but got token " + toString(getTokenType()), getToken());
     }
 
 
     bool isVariableDeclaration() {
-      return tokenIter->type == Keyword_let;
+      return getTokenType() == Keyword_let;
     }
 
     bool isFunctionDeclaration() {
-      return tokenIter->type == Keyword_fun;
+      return getTokenType() == Keyword_fun;
+    }
+
+    bool isLazyParsing() {
+      return lazyFunctionBodies && !tokens.isStreaming();
+    }
+
+    /**
+     * Skip a block from its '{' to the matching '}' without parsing it.
+     * @return index of the first token after the block
+     */
+    size_t skipBlock() {
+      consumeToken(LeftBrace);
+      int depth = 1;
+      while (depth > 0) {
+        if (tokensEmpty()) {
+          throwUnexpectedTokenException({RightBrace}, "while skipping function body");
+        }
+        if (getTokenType() == LeftBrace) {
+          depth++;
+        }
+        else if (getTokenType() == RightBrace) {
+          depth--;
+        }
+        tokens.next();
+      }
+      return tokens.getIndex();
     }
 
 
@@ -176,8 +400,8 @@ class Parser
     /********************************************************
      **** Statements ***************************************
      */
-    unique_ptr<Statement> parseStatement() {
-      unique_ptr<Statement> statement;
+    Statement *parseStatement() {
+      Statement *statement = nullptr;
 
       // check statement type
       if (getTokenType() == Keyword_let) {
@@ -199,48 +423,51 @@ class Parser
       else {
         auto expr = parseExpression();
         // check if its a variable assignment (IdentifierExpression followed by '=')
-        auto varExpr = dynamic_cast<VariableExpression*>(expr.get());
+        auto varExpr = dyn_cast_or_null<VariableExpression>(expr);
         if (varExpr && getTokenType() == Operator_Assign) {
-          expr.release();
-          statement = parseVariableAssignStatement(unique_ptr<VariableExpression>(varExpr));
+          statement = parseVariableAssignStatement(varExpr);
         }
         else {
-          statement = move(expr);
+          statement = expr;
         }
         consumeToken(Semicolon);
         //throwUnexpectedTokenExceptionStr("variable declaration or expression");
       }
 
-      return move(statement);
+      return statement;
     }
 
 
-    unique_ptr<ReturnStatement> parseReturnStatement() {
-      unique_ptr<ReturnStatement> ret = make_unique<ReturnStatement>();
+    ReturnStatement *parseReturnStatement() {
+      ReturnStatement *ret = makeNode<ReturnStatement>();
       consumeToken(Keyword_return, *ret);
 
       // optional expression
       if (getTokenType() != Semicolon) {
         ret->expression = parseExpression();
+        linkChild(ret, ret->expression);
       }
       consumeToken(Semicolon);
-      return move(ret);
+      return ret;
     }
 
 
-    unique_ptr<CompoundStatement> parseCompoundStatement() {
-      unique_ptr<CompoundStatement> comp = make_unique<CompoundStatement>();
+    CompoundStatement *parseCompoundStatement() {
+      CompoundStatement *comp = makeNode<CompoundStatement>();
       consumeToken(LeftBrace, *comp);
       while (!tokensEmpty() && getTokenType() != RightBrace)
       {
         comp->statements.push_back(parseStatement());
       }
       consumeToken(RightBrace);
+      for (auto &statement : comp->statements) {
+        linkChild(comp, statement);
+      }
       return comp;
     }
 
-    unique_ptr<IfStatement> parseIfStatement() {
-      unique_ptr<IfStatement> ifSt = make_unique<IfStatement>();
+    IfStatement *parseIfStatement() {
+      IfStatement *ifSt = makeNode<IfStatement>();
       consumeToken(Keyword_if, *ifSt);
 
       // condition
@@ -254,16 +481,21 @@ class Parser
         consumeToken(Keyword_else);
         ifSt->elseBody = parseCompoundStatement();
       }
+      linkChild(ifSt, ifSt->condition);
+      linkChild(ifSt, ifSt->ifBody);
+      linkChild(ifSt, ifSt->elseBody);
 
       return ifSt;
     }
 
-    unique_ptr<WhileStatement> parseWhileStatement() {
-      unique_ptr<WhileStatement> whileSt = make_unique<WhileStatement>();
+    WhileStatement *parseWhileStatement() {
+      WhileStatement *whileSt = makeNode<WhileStatement>();
 
       consumeToken(Keyword_while, *whileSt);
       whileSt->condition = parseExpression();
       whileSt->body = parseCompoundStatement();
+      linkChild(whileSt, whileSt->condition);
+      linkChild(whileSt, whileSt->body);
 
       return whileSt;
     }
@@ -274,15 +506,16 @@ class Parser
      * The semicolon at the end will not be parsed.
      * Thus only the valueExpression is consumed.
      */
-    unique_ptr<VariableAssignStatement> parseVariableAssignStatement(unique_ptr<VariableExpression> variableExpr) {
-      unique_ptr<VariableAssignStatement> assign = make_unique<VariableAssignStatement>();
+    VariableAssignStatement *parseVariableAssignStatement(VariableExpression *variableExpr) {
+      VariableAssignStatement *assign = makeNode<VariableAssignStatement>();
 
       // variable expression
-      auto identifierToken = tokenIter;
-      assign->variableExpression = move(variableExpr);
+      assign->variableExpression = variableExpr;
 
       consumeToken(Operator_Assign, *assign);
       assign->valueExpression = parseExpression();
+      linkChild(assign, assign->variableExpression);
+      linkChild(assign, assign->valueExpression);
 
       return assign;
     }
@@ -299,23 +532,23 @@ class Parser
       * Parse a variable declaration.
       * @param parentClass if its a member of a class this links to the parent class, then no initial 'let' token is consumed.
       */
-    unique_ptr<VariableDeclaration> parseVariableDeclaration(ClassDeclaration *parentClass = nullptr) {
-      unique_ptr<VariableDeclaration> var = make_unique<VariableDeclaration>();
+    VariableDeclaration *parseVariableDeclaration(ClassDeclaration *parentClass = nullptr) {
+      VariableDeclaration *var = makeNode<VariableDeclaration>();
 
       if (!parentClass) {
         consumeToken(Keyword_let);
       } else {
         var->parentClass = parentClass;
       }
-      var->name = consumeToken(Identifier, *var)->contend;
+      var->name = consumeToken(Identifier, *var).symbol;
 
       // @todo end location not perfect
-      var->location.end = getTokenLocation().getLastLocation();
+      var->location.length = getTokenLocation().offset - var->location.offset;
 
       // optional type
       if (getTokenType() == Colon) {
         consumeToken(Colon);
-        var->typeName = consumeToken(Identifier)->contend;
+        var->typeName = consumeToken(Identifier).symbol;
       }
 
       // init value
@@ -323,38 +556,39 @@ class Parser
       if (!parentClass || getTokenType() == Operator_Assign) {
         consumeToken(Operator_Assign);
         var->initExpression = parseExpression();
+        linkChild(var, var->initExpression);
       }
 
       consumeToken(Semicolon);
-      return move(var);
+      return var;
     }
 
     /**
      * Parse a function declaration.
      * @param parentClass if its a member of a class this links to the parent class.
      */
-    FunctionDeclaration parseFunctionDeclaration(ClassDeclaration *parentClass = nullptr) {
-      FunctionDeclaration func;
+    FunctionDeclaration *parseFunctionDeclaration(ClassDeclaration *parentClass = nullptr) {
+      FunctionDeclaration *func = makeNode<FunctionDeclaration>();
 
       if (parentClass) {
-        func.parentClass = parentClass;
+        func->parentClass = parentClass;
       }
 
-      consumeToken(Keyword_fun, func);
+      consumeToken(Keyword_fun, *func);
 
       // optional extern
       bool isExtern = getTokenType() == Keyword_extern;
-      func.isExtern = isExtern;
+      func->isExtern = isExtern;
       if (isExtern) {
         consumeToken(Keyword_extern);
       }
-      func.name = consumeToken(Identifier)->contend;
+      func->name = consumeToken(Identifier).symbol;
 
       // arguments
       consumeToken(LeftParen);
       while (!tokensEmpty() && getTokenType() != RightParen)
       {
-        func.arguments.push_back(parseFunctionParamDeclaration());
+        func->arguments.push_back(parseFunctionParamDeclaration());
 
         // comma between params
         if (getTokenType() == Comma){
@@ -365,23 +599,33 @@ class Parser
         }
       }
       consumeToken(RightParen);
+      for (auto &arg : func->arguments) {
+        linkChild(func, &arg);
+        linkChild(&arg, arg.defaultExpression);
+      }
 
       // optional return type
       if (getTokenType() == Colon) {
         consumeToken(Colon);
-        func.typeName = consumeToken(Identifier)->contend;
+        func->typeName = consumeToken(Identifier).symbol;
       }
         // if no return type -> use void
       else {
-        func.typeName = "void";
+        func->typeName = "void";
       }
 
       // body
-      if (!isExtern) {
-        func.body = parseCompoundStatement();
+      // bodies of global functions are only parsed when they are needed when lazy parsing
+      if (!isExtern && !parentClass && isLazyParsing()) {
+        func->lazyBodyTokensBegin = tokens.getIndex();
+        func->lazyBodyTokensEnd = skipBlock();
+      }
+      else if (!isExtern) {
+        func->body = parseCompoundStatement();
+        linkChild(func, func->body);
       }
 
-      return move(func);
+      return func;
     }
 
     /**
@@ -391,44 +635,45 @@ class Parser
     FunctionParamDeclaration parseFunctionParamDeclaration() {
       FunctionParamDeclaration param;
 
-      auto paramToken = *tokenIter;
-      param.name = consumeToken(Identifier, param)->contend;
+      Token paramToken = getToken();
+      param.name = consumeToken(Identifier, param).symbol;
 
       // type
       consumeToken(Colon);
-      param.typeName = consumeToken(Identifier)->contend;
+      param.typeName = consumeToken(Identifier).symbol;
 
       // optional init value
       if (getTokenType() == Operator_Assign) {
         consumeToken(Operator_Assign);
-        param.defaultExpression = dynamic_unique_pointer_cast<ConstValueExpression>(parseExpression());
+        param.defaultExpression = dyn_cast_or_null<ConstValueExpression>(parseExpression());
         if (!param.defaultExpression) {
           throw ParseException("only const values are supported for default function arguments", paramToken);
         }
       }
 
-      return move(param);
+      return param;
     }
 
 
     /**
      * Class declaration with member vars and functions.
      */
-    unique_ptr<ClassDeclaration> parseClassDeclaration() {
-      unique_ptr<ClassDeclaration> classDecl = make_unique<ClassDeclaration>();
+    ClassDeclaration *parseClassDeclaration() {
+      ClassDeclaration *classDecl = makeNode<ClassDeclaration>();
+      classDecl->constructor = makeNode<FunctionDeclaration>();
 
       consumeToken(Keyword_class, *classDecl);
-      classDecl->name = consumeToken(Identifier)->contend;
+      classDecl->name = consumeToken(Identifier).symbol;
 
       // member vars and functions
       consumeToken(LeftBrace);
       while (!tokensEmpty() && getTokenType() != RightBrace)
       {
         if (getTokenType() == Keyword_fun) {
-          classDecl->functionDeclarations.push_back(parseFunctionDeclaration(classDecl.get()));
+          classDecl->functionDeclarations.push_back(parseFunctionDeclaration(classDecl));
         }
         else if (getTokenType() == Identifier) {
-          classDecl->variableDeclarations.push_back(parseVariableDeclaration(classDecl.get()));
+          classDecl->variableDeclarations.push_back(parseVariableDeclaration(classDecl));
         }
         else {
           throwUnexpectedTokenException({
@@ -439,7 +684,14 @@ class Parser
       }
       consumeToken(RightBrace);
 
-      return move(classDecl);
+      linkChild(classDecl, classDecl->constructor);
+      for (auto varDecl : classDecl->variableDeclarations) {
+        linkChild(classDecl, varDecl);
+      }
+      for (auto funcDecl : classDecl->functionDeclarations) {
+        linkChild(classDecl, funcDecl);
+      }
+      return classDecl;
     }
 
 
@@ -451,15 +703,9 @@ class Parser
      **** Expressions ***************************************
      */
 
-    unique_ptr<Expression> parseExpression() {
-      unique_ptr<Expression> exprLHS = parsePrimaryExpression();
-
-      if (!exprLHS) {
-        return nullptr;
-      }
-
-      // this will return exprLHS if its not a binary expression
-      return parseBinaryExpressionRHS(move(exprLHS), 0);
+    Expression *parseExpression() {
+      // this will return just the primary expression if its not a binary expression
+      return parseBinaryExpression(0);
     }
 
     /**
@@ -467,8 +713,8 @@ class Parser
      * Examples for Primary expressions: "(...)" or "a".
      * Examples for Non Primary: "a + b" or "a * b + c ...".
      */
-    unique_ptr<Expression> parsePrimaryExpression() {
-      unique_ptr<Expression> expr;
+    Expression *parsePrimaryExpression() {
+      Expression *expr = nullptr;
 
       if (getTokenType() == Identifier) {
         expr = parseIdentifierExpression();
@@ -477,11 +723,11 @@ class Parser
         expr = parseNumberExpression();
       }
       else if (getTokenType() == Keyword_true) {
-        expr = make_unique<BoolExpression>(true);
+        expr = makeNode<BoolExpression>(true);
         consumeToken(Keyword_true, *expr);
       }
       else if (getTokenType() == Keyword_false) {
-        expr = make_unique<BoolExpression>(false);
+        expr = makeNode<BoolExpression>(false);
         consumeToken(Keyword_false, *expr);
       }
       else if (getTokenType() == String) {
@@ -505,15 +751,15 @@ class Parser
             }, "expression");
       }
 
-      return move(expr);
+      return expr;
     }
 
     /**
      * Parses '(...)'.
      * @return nullptr when brace contains no expression
      */
-    unique_ptr<Expression> parseParenExpression() {
-      unique_ptr<Expression> expr = nullptr;
+    Expression *parseParenExpression() {
+      Expression *expr = nullptr;
 
       consumeToken(LeftParen);
       if (getTokenType() != RightParen) {
@@ -521,18 +767,19 @@ class Parser
       }
       consumeToken(RightParen);
 
-      return move(expr);
+      return expr;
     }
 
 
-    unique_ptr<Expression> parseUnaryNotExpression() {
-      unique_ptr<UnaryExpression> expr = make_unique<UnaryExpression>();
+    Expression *parseUnaryNotExpression() {
+      UnaryExpression *expr = makeNode<UnaryExpression>();
 
       consumeToken(Operator_Unary_Not, *expr);
       expr->operation = Expr_Unary_Op_LOGIC_NOT;
       expr->innerExpression = parsePrimaryExpression();
+      linkChild(expr, expr->innerExpression);
 
-      return move(expr);
+      return expr;
     }
 
     /**
@@ -540,18 +787,18 @@ class Parser
      * or call like 'func()'
      * or member expression like 'myObject.memberProp'.
      */
-    unique_ptr<IdentifierExpression> parseIdentifierExpression(unique_ptr<IdentifierExpression> previousMemberExpr = nullptr)
+    IdentifierExpression *parseIdentifierExpression(IdentifierExpression *previousMemberExpr = nullptr)
     {
-      unique_ptr<IdentifierExpression> identifierExpr;
+      IdentifierExpression *identifierExpr = nullptr;
 
       // if next token is '(' is a function call
       if (getNextTokenType() == LeftParen) {
         // if has parent expression -> member call
         if (previousMemberExpr) {
-          auto callExpr = dynamic_cast<MemberCallExpression*>(parseCallExpression(true).release());
-          auto memberCall = unique_ptr<MemberCallExpression>(callExpr);
-          memberCall->parent = move(previousMemberExpr);
-          identifierExpr = move(memberCall);
+          auto memberCall = static_cast<MemberCallExpression*>(parseCallExpression(true));
+          memberCall->parent = previousMemberExpr;
+          linkChild(memberCall, memberCall->parent);
+          identifierExpr = memberCall;
         }
         else {
           identifierExpr = parseCallExpression();
@@ -561,22 +808,23 @@ class Parser
       else {
         // if has parent expression -> member variable
         if (previousMemberExpr) {
-          auto member = make_unique<MemberVariableExpression>();
-          member->name = consumeToken(Identifier, *member)->contend;
-          member->parent = move(previousMemberExpr);
-          identifierExpr = move(member);
+          auto member = makeNode<MemberVariableExpression>();
+          member->name = consumeToken(Identifier, *member).symbol;
+          member->parent = previousMemberExpr;
+          linkChild(member, member->parent);
+          identifierExpr = member;
         }
         else {
-          auto variable = make_unique<VariableExpression>();
-          variable->name = consumeToken(Identifier, *variable)->contend;
-          identifierExpr = move(variable);
+          auto variable = makeNode<VariableExpression>();
+          variable->name = consumeToken(Identifier, *variable).symbol;
+          identifierExpr = variable;
         }
       }
 
       // has follow expression
       if (getTokenType() == Dot) {
         consumeToken(Dot);
-        return parseIdentifierExpression(move(identifierExpr));
+        return parseIdentifierExpression(identifierExpr);
       }
       else {
         return identifierExpr;
@@ -585,15 +833,15 @@ class Parser
 
 
 
-    unique_ptr<CallExpression> parseCallExpression(bool isMemberCall = false)
+    CallExpression *parseCallExpression(bool isMemberCall = false)
     {
-      unique_ptr<CallExpression> call;
+      CallExpression *call = nullptr;
       if (isMemberCall) {
-        call = make_unique<MemberCallExpression>();
+        call = makeNode<MemberCallExpression>();
       } else {
-        call = make_unique<CallExpression>();
+        call = makeNode<CallExpression>();
       }
-      call->calledName = consumeToken(Identifier, *call)->contend;
+      call->calledName = consumeToken(Identifier, *call).symbol;
 
       // arguments
       consumeToken(LeftParen);
@@ -610,7 +858,7 @@ class Parser
         if (getTokenType() == Identifier &&
             (getNextTokenType() == Operator_Assign || getNextTokenType() == Colon))
         {
-          arg.argName = consumeToken(Identifier)->contend;
+          arg.argName = consumeToken(Identifier).symbol;
           if (getTokenType() == Operator_Assign) {
             consumeToken(Operator_Assign);
           } else {
@@ -621,7 +869,7 @@ class Parser
         }
         // non named arguments are not allowed after named
         else if(gotNamedArgument) {
-          throw ParseException("unnamed arguments are not allowed after named arguments of a function call", *tokenIter);
+          throw ParseException("unnamed arguments are not allowed after named arguments of a function call", getToken());
         }
 
         // now value expression
@@ -642,108 +890,105 @@ class Parser
         }
       }
       consumeToken(RightParen);
+
+      for (auto &arg : call->argumentsNonNamed) {
+        linkChild(call, &arg);
+        linkChild(&arg, arg.expression);
+      }
+      for (auto &arg : call->argumentsNamed) {
+        linkChild(call, &arg);
+        linkChild(&arg, arg.expression);
+      }
       return call;
     }
 
 
-    unique_ptr<Expression> parseStringExpression() {
-      auto expr = make_unique<StringExpression>();
-      expr->value = consumeToken(String, *expr)->contend;
-      return move(expr);
+    Expression *parseStringExpression() {
+      auto expr = makeNode<StringExpression>();
+      expr->value = consumeToken(String, *expr).contend;
+      return expr;
     }
 
-    unique_ptr<Expression> parseNumberExpression() {
-      unique_ptr<NumberExpression> expr;
+    Expression *parseNumberExpression() {
+      NumberExpression *expr = nullptr;
       string contend;
       Token numberToken;
 
       bool isNegative = getTokenType() == Operator_Minus;
       if (isNegative) {
         consumeToken(Operator_Minus);
-        numberToken = *consumeToken(Number);
-        contend = "-" + numberToken.contend;
+        numberToken = consumeToken(Number);
+        contend = "-" + string(numberToken.contend);
       }
       else {
-        numberToken = *consumeToken(Number);
+        numberToken = consumeToken(Number);
         contend = numberToken.contend;
       }
 
       try {
         // if its a integer
         if (contend.find('.') == string::npos) {
-          auto exprInt = make_unique<NumberIntExpression>();
+          auto exprInt = makeNode<NumberIntExpression>();
           exprInt->value = stoi(contend);
           exprInt->location = numberToken.location;
-          expr = move(exprInt);
+          expr = exprInt;
         }
           // when its a floating point
         else {
-          auto exprFloat = make_unique<NumberFloatExpression>();
+          auto exprFloat = makeNode<NumberFloatExpression>();
           exprFloat->value = stof(contend);
           exprFloat->location = numberToken.location;
-          expr = move(exprFloat);
+          expr = exprFloat;
         }
       }
       catch(exception &e) {
         throw ParseException(string("can't convert NumberExpression to number: ") + e.what(), numberToken);
       }
 
-      return move(expr);
+      return expr;
     }
 
     /**
-     * Parses chain of "a + b * c - d ..."
-     * until it reaches a non binop expression or next binary op precedence is lower than precedenceHigherThan.
-     * This will respect operator precedence.
-     * If it is not a binary expression like 'a' it will return given lhs expression.
-     * @param lhsExpression a already parsed expression, in example above this would be 'a'
-     * @param precedenceHigherThan has to be >= 0, next binary ops are only parsed if there precedence is higher than that
+     * Parses chain of "a + b * c - d ..." (pratt parser)
+     * until it reaches a non binop expression or the binding power of the next binary op is not higher than minBindingPower.
+     * Binding powers come from binaryOperatorTable, all binary ops are left associative.
+     * Every operand and operator is visited once, thus long chains are parsed in a single linear pass.
+     * If it is not a binary expression like 'a' it will return just the primary expression.
+     * @param minBindingPower has to be >= 0, next binary ops are only parsed if there binding power is higher than that
      */
-    unique_ptr<Expression> parseBinaryExpressionRHS(unique_ptr<Expression> lhsExpression, int precedenceHigherThan) {
+    Expression *parseBinaryExpression(int minBindingPower) {
+      Expression *lhsExpression = parsePrimaryExpression();
+      if (!lhsExpression) {
+        return nullptr;
+      }
 
       // parse binary expression chain until its end
       while (true)
       {
-        // return lhs if its not a binary expression
-        // or lastBinOp is stronger then current currentBinOp
-        BinaryExpressionOp currentBinOp = BinaryExpression::tokenToBinaryExpressionOp(getTokenType());
-        if (currentBinOp == Expr_Op_Invalid || currentBinOp < precedenceHigherThan)
+        // return lhs if its not a binary op or the op binds weaker than the caller's op
+        const BinaryOperatorInfo &binOp = getBinaryOperator(getTokenType());
+        if (binOp.bindingPower <= minBindingPower)
         {
           return lhsExpression;
         }
 
-        // now its a binOp that is stronger then last
-        // so consume the operator
-        auto opLocation = consumeToken(getTokenType())->location;
-
-        // now parse rhs
-        auto rhsExpression = parsePrimaryExpression();
+        auto opLocation = consumeToken(getTokenType()).location;
 
-        // check if there is a next binary op
-        // if there is one and its binding is stronger then currentBinOp
-        // -> a new binOp is constructed with rhs and all following rhs with stronger binding than current
-        // -> then current rhs is set to that new binary op
-        BinaryExpressionOp nextBinOp = BinaryExpression::tokenToBinaryExpressionOp(getTokenType());
-        if (nextBinOp != Expr_Op_Invalid && currentBinOp < nextBinOp)
-        {
-          // parse all following binary ops with stronger precedence than current
-          rhsExpression = parseBinaryExpressionRHS(move(rhsExpression), currentBinOp + 1);
-        }
+        // rhs takes all following ops that bind stronger than current
+        // ops with the same binding power stay in this loop -> left associative
+        auto rhsExpression = parseBinaryExpression(binOp.bindingPower);
 
         // merge lhs and rhs
         // -> then it becomes the new lhs
-        auto newBinary = make_unique<BinaryExpression>();
-        newBinary->lhs = move(lhsExpression);
-        newBinary->rhs = move(rhsExpression);
-        newBinary->operation = currentBinOp;
+        auto newBinary = makeNode<BinaryExpression>();
+        newBinary->lhs = lhsExpression;
+        newBinary->rhs = rhsExpression;
+        newBinary->operation = binOp.operation;
         newBinary->location = opLocation;
-        lhsExpression = move(newBinary);
+        linkChild(newBinary, newBinary->lhs);
+        linkChild(newBinary, newBinary->rhs);
+        lhsExpression = newBinary;
       }
-
-
-      auto expr = make_unique<BinaryExpression>();
-      //expr->value = consumeToken(String)->contend;
-      return move(expr);
     }
 };
 
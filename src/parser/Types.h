@@ -1,21 +1,49 @@
 #pragma once
 
 #include <list>
+#include <memory>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
 #include <magic_enum.hpp>
 #include <iostream>
 #include "util/util.h"
+#include "util/Casting.h"
 using namespace std;
 
 class ClassDeclaration;
 
 
+/**
+ * Kind of a LangType, used by isa<>/dyn_cast<> of the types.
+ * Kinds of derived types of an abstract type lie between its _First and _Last kind.
+ */
+enum LANG_TYPE_KIND {
+    LangType_Invalid,
+    LangType_Reference,
+
+    LangType_UserDefined_First,
+    LangType_Class = LangType_UserDefined_First,
+    LangType_UserDefined_Last = LangType_Class,
+
+    LangType_BuildIn,
+};
+
 
 /**
  * Types
+ * There is only one instance of each type, it is owned by the TypeContext of the ast,
+ * thus nodes link to types via raw pointers and types are compared by pointer.
  */
 class LangType {
   public:
-    virtual std::unique_ptr<LangType> clone() const = 0;
+    const LANG_TYPE_KIND kind;
+
+    explicit LangType(LANG_TYPE_KIND kind) : kind(kind)
+    {}
+
+    LangType(const LangType &) = delete;
+    LangType &operator=(const LangType &) = delete;
 
     virtual void print(int depth) {
       cout << /*ASTNode::depthToTabs(depth) <<*/ "Type(" << toString() << ")" << endl;
@@ -23,7 +51,12 @@ class LangType {
 
     virtual string toString() { return ""; };
 
-    virtual bool equals(LangType *other) = 0;
+    /**
+     * The invalid type is not equal to any type, not even to itself.
+     */
+    bool equals(const LangType *other) const {
+      return this == other && kind != LangType_Invalid;
+    }
 
     virtual bool isInvalid()        { return false; }
     virtual bool isVoidType()       { return false; }
@@ -37,15 +70,16 @@ class LangType {
 
 class InvalidType: public LangType {
   public:
-    unique_ptr<LangType> clone() const override{
-      return std::unique_ptr<InvalidType>();
+    InvalidType() : LangType(LangType_Invalid)
+    {}
+
+    static bool classof(const LangType *type) {
+      return type->kind == LangType_Invalid;
     }
+
     string toString() override{
       return "InvalidType";
     }
-    bool equals(LangType *other) override {
-      return false;
-    }
     bool isInvalid() override
     { return true; }
 };
@@ -53,53 +87,45 @@ class InvalidType: public LangType {
 
 class ReferenceType: public LangType {
   public:
-    unique_ptr<LangType> innerType;
+    LangType *innerType;
 
-    ReferenceType(unique_ptr<LangType> innerType) : innerType(move(innerType))
+    explicit ReferenceType(LangType *innerType) : LangType(LangType_Reference), innerType(innerType)
     {}
 
-    ReferenceType(const ReferenceType &original) : innerType(original.innerType->clone())
-    { }
-
-    std::unique_ptr<LangType> clone() const override {
-      return make_unique<ReferenceType>(*this);
+    static bool classof(const LangType *type) {
+      return type->kind == LangType_Reference;
     }
 
     string toString() override {
       return "Reference<"+ innerType->toString() +">";
     }
-    bool equals(LangType *other) override {
-      if (auto* o = dynamic_cast<ReferenceType*>(other)) {
-        return o->innerType->equals(this->innerType.get());
-      }
-      return false;
-    }
 };
 
 
 class UserDefinedType: public LangType {
+  public:
+    static bool classof(const LangType *type) {
+      return type->kind >= LangType_UserDefined_First && type->kind <= LangType_UserDefined_Last;
+    }
+
+  protected:
+    explicit UserDefinedType(LANG_TYPE_KIND kind) : LangType(kind)
+    {}
 };
 
 class ClassType: public UserDefinedType {
   public:
     ClassDeclaration *classDeclaration;
 
-    explicit ClassType(ClassDeclaration *classDecl): classDeclaration(classDecl)
+    explicit ClassType(ClassDeclaration *classDecl): UserDefinedType(LangType_Class), classDeclaration(classDecl)
     { }
 
-    std::unique_ptr<LangType> clone() const override {
-      return make_unique<ClassType>(*this);
+    static bool classof(const LangType *type) {
+      return type->kind == LangType_Class;
     }
 
     string toString() override;
 
-    bool equals(LangType *other) override {
-      if (auto* o = dynamic_cast<ClassType*>(other)) {
-        return o->classDeclaration == this->classDeclaration;
-      }
-      return false;
-    }
-
     bool isClassType() override {
       return true;
     }
@@ -119,24 +145,20 @@ enum BUILD_IN_TYPE {
     BuildIn_bool,
     // static string (has contend and length)
     BuildIn_str, // @todo will be replaced by predefined str class
+
+    BuildIn_Count
 };
 class BuildInType: public LangType {
   public:
     BUILD_IN_TYPE type = BuildIn_No_BuildIn;
 
-    BuildInType() {}
-    BuildInType(BUILD_IN_TYPE type) : type(type)
+    BuildInType() : LangType(LangType_BuildIn)
+    {}
+    BuildInType(BUILD_IN_TYPE type) : LangType(LangType_BuildIn), type(type)
     {}
 
-    bool equals(LangType *other) override{
-      if (auto* o = dynamic_cast<BuildInType*>(other)) {
-        return o->type == this->type;
-      }
-      return false;
-    }
-
-    virtual std::unique_ptr<LangType> clone() const override{
-      return make_unique<BuildInType>(*this);
+    static bool classof(const LangType *type) {
+      return type->kind == LangType_BuildIn;
     }
 
     string toString() override
@@ -182,5 +204,66 @@ static string buildInTypeToString(BUILD_IN_TYPE type) {
       return "bool";
     case BuildIn_str:
       return "str";
+    case BuildIn_Count:
+      return "Count";
   }
-}
\ No newline at end of file
+}
+
+
+/**
+ * Owns the single instance of each type of an ast.
+ * Can be used by multiple threads at once (e.g. when decorating functions in parallel).
+ */
+class TypeContext
+{
+  public:
+    TypeContext() = default;
+    TypeContext(const TypeContext &) = delete;
+    TypeContext &operator=(const TypeContext &) = delete;
+
+    InvalidType *getInvalidType() {
+      return &invalidType;
+    }
+
+    BuildInType *getBuildInType(BUILD_IN_TYPE type) {
+      if (type < 0 || type >= BuildIn_Count) {
+        throw out_of_range("no build in type " + to_string(type));
+      }
+      return &buildInTypes[type];
+    }
+
+    ClassType *getClassType(ClassDeclaration *classDecl) {
+      return getOrCreate(classTypes, classDecl);
+    }
+
+    ReferenceType *getReferenceType(LangType *innerType) {
+      return getOrCreate(referenceTypes, innerType);
+    }
+
+  private:
+    InvalidType invalidType;
+    BuildInType buildInTypes[BuildIn_Count] = {BuildIn_i32, BuildIn_f32, BuildIn_void, BuildIn_bool, BuildIn_str};
+
+    shared_mutex mutex;
+    unordered_map<ClassDeclaration*, unique_ptr<ClassType>> classTypes;
+    unordered_map<LangType*, unique_ptr<ReferenceType>> referenceTypes;
+
+    template<class T, class KEY>
+    T *getOrCreate(unordered_map<KEY*, unique_ptr<T>> &types, KEY *key) {
+      {
+        shared_lock lock(mutex);
+        auto it = types.find(key);
+        if (it != types.end()) {
+          return it->second.get();
+        }
+      }
+
+      unique_lock lock(mutex);
+      // may have been added by an other thread in the meantime
+      auto &type = types[key];
+      if (!type) {
+        type = make_unique<T>(key);
+      }
+      return type.get();
+    }
+};
\ No newline at end of file
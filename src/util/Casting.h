@@ -0,0 +1,14 @@
+#pragma once
+#include <llvm/Support/Casting.h>
+
+
+/**
+ * LLVM-style rtti for ast nodes and lang types.
+ * These classes store a kind tag and provide 'static bool classof(const Base *)' that checks it,
+ * thus isa<>/cast<>/dyn_cast<> are a compare of the tag instead of a dynamic_cast.
+ * Use dyn_cast_or_null<> when the pointer can be null.
+ */
+using llvm::isa;
+using llvm::cast;
+using llvm::dyn_cast;
+using llvm::dyn_cast_or_null;
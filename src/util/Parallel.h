@@ -0,0 +1,55 @@
+#pragma once
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <functional>
+#include <exception>
+#include <algorithm>
+
+using namespace std;
+
+
+/**
+ * Amount of threads to use for parallel work, at least 1.
+ */
+static unsigned getWorkerThreadsCount()
+{
+  return max(1u, thread::hardware_concurrency());
+}
+
+/**
+ * Run task(i) for all i in [0, count) on up to threadsCount threads (the calling thread is one of them).
+ * Returns when all tasks are done.
+ * When tasks throw, the exception of the task with the lowest index is rethrown.
+ */
+static void parallelFor(size_t count, const function<void(size_t)> &task, unsigned threadsCount = getWorkerThreadsCount())
+{
+  vector<exception_ptr> errors(count);
+  atomic<size_t> nextTask = 0;
+  auto worker = [&]() {
+    for (size_t i = nextTask++; i < count; i = nextTask++) {
+      try {
+        task(i);
+      }
+      catch (...) {
+        errors[i] = current_exception();
+      }
+    }
+  };
+
+  vector<thread> threads;
+  size_t usedThreads = min<size_t>(threadsCount, count);
+  for (size_t i = 1; i < usedThreads; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  for (auto &error : errors) {
+    if (error) {
+      rethrow_exception(error);
+    }
+  }
+}
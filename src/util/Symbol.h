@@ -0,0 +1,158 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <ostream>
+#include <functional>
+
+using namespace std;
+
+
+/**
+ * Interned name (e.g. of an identifier).
+ * Each distinct text exists only once in the SymbolTable, thus symbols are compared and hashed by pointer.
+ */
+class Symbol
+{
+  public:
+    /**
+     * The empty symbol.
+     */
+    Symbol() : text(&emptyText())
+    {}
+
+    /**
+     * Intern the text.
+     */
+    Symbol(string_view text);
+    Symbol(const string &text) : Symbol(string_view(text))
+    {}
+    Symbol(const char *text) : Symbol(string_view(text))
+    {}
+
+    const string &str() const {
+      return *text;
+    }
+
+    const char *c_str() const {
+      return text->c_str();
+    }
+
+    size_t length() const {
+      return text->length();
+    }
+
+    bool empty() const {
+      return text->empty();
+    }
+
+    bool operator==(const Symbol &other) const {
+      return text == other.text;
+    }
+
+    bool operator==(const string &other) const {
+      return *text == other;
+    }
+
+    bool operator==(const char *other) const {
+      return *text == other;
+    }
+
+    size_t hash() const {
+      return std::hash<const string*>()(text);
+    }
+
+    static const string &emptyText() {
+      static const string empty;
+      return empty;
+    }
+
+  private:
+    const string *text;
+
+    friend class SymbolTable;
+    explicit Symbol(const string *text) : text(text)
+    {}
+};
+
+namespace std {
+  template<>
+  struct hash<Symbol> {
+    size_t operator()(const Symbol &symbol) const {
+      return symbol.hash();
+    }
+  };
+}
+
+
+/**
+ * Stores the text of all symbols.
+ * Can be used by multiple threads at once (e.g. when lexing in parallel).
+ */
+class SymbolTable
+{
+  public:
+    Symbol intern(string_view text) {
+      if (text.empty()) {
+        return Symbol();
+      }
+
+      {
+        shared_lock lock(mutex);
+        auto it = symbols.find(text);
+        if (it != symbols.end()) {
+          return Symbol(it->second);
+        }
+      }
+
+      unique_lock lock(mutex);
+      // may have been added by an other thread in the meantime
+      auto it = symbols.find(text);
+      if (it != symbols.end()) {
+        return Symbol(it->second);
+      }
+      const string *stored = &texts.emplace_back(text);
+      symbols.insert({string_view(*stored), stored});
+      return Symbol(stored);
+    }
+
+  private:
+    shared_mutex mutex;
+    // deque never moves its elements, thus the symbols can point to them
+    deque<string> texts;
+    unordered_map<string_view, const string*> symbols;
+};
+
+/**
+ * The table used for all symbols.
+ */
+inline SymbolTable &getSymbolTable() {
+  static SymbolTable symbolTable;
+  return symbolTable;
+}
+
+inline Symbol::Symbol(string_view text) : Symbol(getSymbolTable().intern(text))
+{}
+
+inline string operator+(const string &a, const Symbol &b) {
+  return a + b.str();
+}
+
+inline string operator+(const Symbol &a, const string &b) {
+  return a.str() + b;
+}
+
+inline string operator+(const char *a, const Symbol &b) {
+  return a + b.str();
+}
+
+inline string operator+(const Symbol &a, const char *b) {
+  return a.str() + b;
+}
+
+inline ostream &operator<<(ostream &os, const Symbol &symbol) {
+  return os << symbol.str();
+}
@@ -0,0 +1,104 @@
+#include <vector>
+#include <iostream>
+#include <experimental/filesystem>
+#include <termcolor/termcolor.hpp>
+#include <ir/builder/exceptions.h>
+#include "Log.h"
+#include "lexer/Lexer.h"
+#include "parser/Parser.h"
+#include "SourceManager.h"
+#include "AstVisitor/AstPrinter.h"
+#include "decorator/AstDecorator.h"
+#include "parser/AST_addFunc.h"
+#include "AstCache/AstCache.h"
+#include "CorpusGenerator.h"
+#include "TestHelper.h"
+
+using namespace std;
+namespace fs = std::experimental::filesystem;
+
+
+RootDeclarations parseAndDecorate(TestSource &testSource, const string &source, bool lazyParsing) {
+  testSource.use(source);
+  Parser parser(Lexer(source).getAllTokens());
+  parser.setLazyFunctionBodies(lazyParsing);
+  RootDeclarations root = parser.parse();
+  check(AstDecorator().linkNames(root), "decorating the source failed");
+  return root;
+}
+
+
+/**
+ * Program entry point
+ * Checks that a decorated ast is the same after serializing and deserializing it,
+ * that truncated ast files are rejected and that asts with bodies skipped by lazy parsing are not cached.
+ */
+int main(int argc, const char **argv) {
+  CorpusConfig config;
+  config.functions = 300;
+  config.classes = 30;
+  string source = CorpusGenerator(config).generate();
+  TestSource testSource("ast-cache-test");
+  RootDeclarations root = parseAndDecorate(testSource, source, false);
+  string expectedTree = printTree(root);
+
+  // round trip in memory
+  vector<char> data = AstSerializer().serialize(root, AstCache::hashSource(source));
+  {
+    RootDeclarations loaded;
+    AstDeserializer(string_view(data.data(), data.size())).deserialize(loaded);
+    check(printTree(loaded) == expectedTree, "printed tree of the deserialized ast differs");
+    string differentLink = compareLinks(root, loaded);
+    check(differentLink.empty(), "deserialized ast differs in the link to " + differentLink);
+  }
+
+  // truncated data has to be rejected, check every length near the header and the end, a sample in between
+  size_t truncatedAccepted = 0;
+  for (size_t length = 0; length < data.size(); length += (length < 256 || length + 256 > data.size()) ? 1 : data.size() / 500 + 1) {
+    RootDeclarations loaded;
+    try {
+      AstDeserializer(string_view(data.data(), length)).deserialize(loaded);
+      truncatedAccepted++;
+    }
+    catch (runtime_error &e) {
+    }
+  }
+  check(truncatedAccepted == 0, to_string(truncatedAccepted) + " truncated ast files were accepted");
+
+  // round trip through the cache files
+  fs::path directory = fs::temp_directory_path() / ("malinc-ast-cache-test-" + to_string(getpid()));
+  fs::remove_all(directory);
+  {
+    AstCache cache(directory);
+    check(cache.save(source, root), "ast was not saved");
+    RootDeclarations loaded;
+    check(cache.load(source, loaded), "saved ast was not loaded");
+    check(printTree(loaded) == expectedTree, "printed tree of the cached ast differs");
+    RootDeclarations other;
+    check(!cache.load(source + " ", other), "ast of a other source was loaded");
+  }
+
+  // bodies skipped by lazy parsing are decorated without lazy parsing, thus such asts are not cached
+  {
+    string lazySource =
+        "fun main(): i32 {\n  return 0;\n}\n"
+        "fun unused() {\n  let x: i32 = true;\n}\n";
+    RootDeclarations lazyRoot = parseAndDecorate(testSource, lazySource, true);
+    check(AstCache::hasUnparsedBodies(lazyRoot), "lazy parsing parsed the unused function");
+    AstCache cache(directory);
+    check(!cache.save(lazySource, lazyRoot), "ast with unparsed bodies was saved");
+    RootDeclarations loaded;
+    check(!cache.load(lazySource, loaded), "ast with unparsed bodies was loaded");
+    bool thrown = false;
+    try {
+      AstSerializer().serialize(lazyRoot, AstCache::hashSource(lazySource));
+    }
+    catch (runtime_error &e) {
+      thrown = true;
+    }
+    check(thrown, "ast with unparsed bodies was serialized");
+  }
+  fs::remove_all(directory);
+
+  return testResult("ast of " + to_string(data.size()) + " bytes passed round trip and truncation checks");
+}
@@ -1,107 +1,191 @@
-#include <parser/AstIterator/AstNodeChildIterator.h>
+#include <set>
+#include <vector>
+#include <iostream>
+#include <experimental/filesystem>
+#include <termcolor/termcolor.hpp>
+#include <ir/builder/exceptions.h>
+#include "Log.h"
+#include "lexer/Lexer.h"
+#include "parser/Parser.h"
+#include "SourceManager.h"
+#include "decorator/AstDecorator.h"
+#include "parser/AST_addFunc.h"
+#include "CorpusGenerator.h"
+#include "TestHelper.h"
 
+using namespace std;
+namespace fs = std::experimental::filesystem;
 
-int *toPtr(int &i) {
-  return &i;
-}
-
-int first = 99;
-int second = 9922;
-vector<int> vec1 = {};//{1,2};
-vector<int> vec2 = {22,33,44};
 
-/*
-struct X {
-    auto retRange(bool x) {
-      if (x)
-      return join(boost::irange(0, 1)  | transformed([&](int i) {
-        return &first;
-      }), vec1 | transformed(toPtr));
+/**
+ * Children of the node read from its fields, in the order getChildNodes() returns them:
+ * first the fixed children that are not null, then the elements of the containers.
+ */
+vector<ASTNode*> childrenOfFields(ASTNode *node) {
+  vector<ASTNode*> children;
+  auto add = [&](ASTNode *child) {
+    if (child) {
+      children.push_back(child);
     }
-};
-*/
-
-using IntIteratorRange = IteratorRange<CounterConcatIterator<int*>, CounterConcatIteratorEnd>;
+  };
+  auto addArguments = [&](CallExpression *call) {
+    for (auto &arg : call->argumentsNonNamed) {
+      children.push_back(&arg);
+    }
+    for (auto &arg : call->argumentsNamed) {
+      children.push_back(&arg);
+    }
+  };
 
-/*
-template <class VALUE, class CONTAINER>
-containerIter<VALUE> makeContainerIterPtr(CONTAINER &vec) {
-  return containerIter<int *>(vec.size(), [&, vecIter = vec.begin()](int index) mutable {
-    return &*vecIter++;
-  });
+  switch (node->kind) {
+    case Node_RootDeclarations: {
+      auto root = cast<RootDeclarations>(node);
+      children.insert(children.end(), root->classDeclarations.begin(), root->classDeclarations.end());
+      children.insert(children.end(), root->variableDeclarations.begin(), root->variableDeclarations.end());
+      children.insert(children.end(), root->functionDeclarations.begin(), root->functionDeclarations.end());
+      break;
+    }
+    case Node_FunctionDeclaration: {
+      auto func = cast<FunctionDeclaration>(node);
+      add(func->body);
+      for (auto &arg : func->arguments) {
+        children.push_back(&arg);
+      }
+      break;
+    }
+    case Node_FunctionParamDeclaration:
+      add(cast<FunctionParamDeclaration>(node)->defaultExpression);
+      break;
+    case Node_ClassDeclaration: {
+      auto classDecl = cast<ClassDeclaration>(node);
+      add(classDecl->constructor);
+      add(classDecl->thisVarDecl);
+      children.insert(children.end(), classDecl->variableDeclarations.begin(), classDecl->variableDeclarations.end());
+      children.insert(children.end(), classDecl->functionDeclarations.begin(), classDecl->functionDeclarations.end());
+      break;
+    }
+    case Node_CallExpressionArgument:
+      add(cast<CallExpressionArgument>(node)->expression);
+      break;
+    case Node_VariableDeclaration:
+      add(cast<VariableDeclaration>(node)->initExpression);
+      break;
+    case Node_ReturnStatement:
+      add(cast<ReturnStatement>(node)->expression);
+      break;
+    case Node_CompoundStatement: {
+      auto &statements = cast<CompoundStatement>(node)->statements;
+      children.insert(children.end(), statements.begin(), statements.end());
+      break;
+    }
+    case Node_IfStatement: {
+      auto ifSt = cast<IfStatement>(node);
+      add(ifSt->condition);
+      add(ifSt->ifBody);
+      add(ifSt->elseBody);
+      break;
+    }
+    case Node_WhileStatement: {
+      auto whileSt = cast<WhileStatement>(node);
+      add(whileSt->condition);
+      add(whileSt->body);
+      break;
+    }
+    case Node_VariableAssignStatement: {
+      auto assign = cast<VariableAssignStatement>(node);
+      add(assign->variableExpression);
+      add(assign->valueExpression);
+      break;
+    }
+    case Node_UnaryExpression:
+      add(cast<UnaryExpression>(node)->innerExpression);
+      break;
+    case Node_BinaryExpression: {
+      auto binary = cast<BinaryExpression>(node);
+      add(binary->lhs);
+      add(binary->rhs);
+      break;
+    }
+    case Node_MemberVariableExpression:
+      add(cast<MemberVariableExpression>(node)->parent);
+      break;
+    case Node_CallExpression:
+      addArguments(cast<CallExpression>(node));
+      break;
+    case Node_MemberCallExpression: {
+      auto call = cast<MemberCallExpression>(node);
+      add(call->parent);
+      addArguments(call);
+      break;
+    }
+    default:
+      // variables and const values have no children
+      break;
+  }
+  return children;
 }
-*/
 
 /**
- * Program entry point
+ * Compare the children of the node and all its descendants with the children read from their fields.
+ * @param kinds collects the kinds of all visited nodes
+ * @return amount of nodes whose children differ
  */
-int main(int argc, const char **argv) {
-
+size_t countDifferentChildren(ASTNode *node, set<AST_NODE_KIND> &kinds) {
+  kinds.insert(node->kind);
+  vector<ASTNode*> children;
+  for (auto child : node->getChildNodes()) {
+    children.push_back(child);
+  }
 
-  /*
-  function<optional<int>()> func = [i = 0]() mutable -> optional<int> {
-    cout << "  -- gen element -- " << i << endl;
-    i++;
-    if (i <= 10) {
-      return i;
-    }
-    else {
-      return nullopt;
-    }
-  };
+  size_t differences = 0;
+  vector<ASTNode*> expected = childrenOfFields(node);
+  if (children != expected) {
+    cout << "ERR: children of " << node->nodeName() << " differ: " << children.size() << " children, "
+         << expected.size() << " expected" << endl;
+    differences++;
+  }
+  for (auto child : children) {
+    differences += countDifferentChildren(child, kinds);
+  }
+  return differences;
+}
 
-  IteratorRange it(func);
-   */
-/*
-  IntIteratorRange iter = makeValueContainerIter<int *>({&first, &second}, {
-      makeItVec<int*>(vec1),
-      containerIter<int *>(vec2.size(), [&](int index) mutable {
-        cout << "vec2Iter i: " << index << endl;
-        return &vec2[index];
-      })
-  });
-  */
-  int last = 2266;
-  IntIteratorRange iter = makeValueContainerIter<int*>(
-      {{&first, nullptr, &second, nullptr}},{
-          makeContainerIter_ValueToPtr<int>(vec1),
-          makeContainerIter_ValueToPtr<int>(vec2),
-  });
 
-  IntIteratorRange iter2 = makeValueContainerIter<int*>(
-      {{&first, &second}},{
-          //makeContainerIter_ValueToPtr<int>(vec1),
-          //makeContainerIter_ValueToPtr<int>(vec2),
-      });
-  IntIteratorRange iter3 = makeValueContainerIter<int*>(
-      {nullptr, &first, nullptr},{
-          makeContainerIter_ValueToPtr<int>(vec1),
-          makeContainerIter_ValueToPtr<int>(vec2),
-      });
+/**
+ * Program entry point
+ * Parses and decorates a generated program and checks that getChildNodes() of all its nodes returns
+ * the children stored in the fields of the node, in the same order. The program contains all node kinds.
+ */
+int main() {
+  CorpusConfig config;
+  config.functions = 200;
+  config.statementDepth = 3;
+  config.classes = 20;
+  string source = CorpusGenerator(config).generate()
+                  + "\nlet ratio: f32 = 1.5;\n"
+                  + "let name: str = \"malinc\";\n"
+                  + "let enabled: bool = true;\n";
+  TestSource testSource("ast-children-test");
+  testSource.use(source);
 
-/*
-  auto it = makeCountedRange<int*>([&, vec1Iter = vec1.begin(), vec2Iter = vec2.begin()](int index) mutable {
-    if (index <= 0)
-      return &first;
-    if (index <= vec1.size())
-      return &*vec1Iter++;
-    if (index <= vec1.size()+vec2.size())
-      return &*vec2Iter++;
-  }, vec1.size()+vec2.size()+1);
-*/
-  /*
-  auto it = join(boost::irange(0, 1)  | transformed([&](int i) {
-    return &first;
-  }), vec1 | transformed(toPtr));
-  */
+  RootDeclarations root = Parser(Lexer(source).getAllTokens()).parse();
+  check(AstDecorator().linkNames(root), "decorating the generated program failed");
 
-  //vector<int> v;
-  //v.insert(v.end(), vec1.begin(), vec1.end());
-  //v.insert(v.end(), vec2.begin(), vec2.end());
+  set<AST_NODE_KIND> kinds;
+  size_t differences = countDifferentChildren(&root, kinds);
+  check(differences == 0, "children of " + to_string(differences) + " nodes differ");
 
-  cout << "elements: " << endl;
-  for (auto el : iter3) {
-    //(*el)++;
-    cout << "el: " << *el << endl << endl;
+  vector<AST_NODE_KIND> allKinds = {
+      Node_RootDeclarations, Node_FunctionDeclaration, Node_FunctionParamDeclaration, Node_ClassDeclaration,
+      Node_CallExpressionArgument, Node_VariableDeclaration, Node_ReturnStatement, Node_CompoundStatement,
+      Node_IfStatement, Node_WhileStatement, Node_VariableAssignStatement, Node_UnaryExpression,
+      Node_BinaryExpression, Node_VariableExpression, Node_MemberVariableExpression, Node_CallExpression,
+      Node_MemberCallExpression, Node_NumberIntExpression, Node_NumberFloatExpression, Node_StringExpression,
+      Node_BoolExpression
+  };
+  for (auto kind : allKinds) {
+    check(kinds.count(kind) > 0, "generated program contains no node of kind " + to_string(kind));
   }
-}
\ No newline at end of file
+
+  return testResult("children of all nodes of " + to_string(kinds.size()) + " kinds match their fields");
+}
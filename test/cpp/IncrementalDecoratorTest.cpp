@@ -0,0 +1,161 @@
+#include <random>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <experimental/filesystem>
+#include <termcolor/termcolor.hpp>
+#include <ir/builder/exceptions.h>
+#include "Log.h"
+#include "lexer/Lexer.h"
+#include "parser/Parser.h"
+#include "parser/IncrementalParser.h"
+#include "SourceManager.h"
+#include "AstVisitor/AstPrinter.h"
+#include "decorator/AstDecorator.h"
+#include "decorator/IncrementalDecorator.h"
+#include "parser/AST_addFunc.h"
+#include "CorpusGenerator.h"
+#include "TestHelper.h"
+
+using namespace std;
+namespace fs = std::experimental::filesystem;
+
+
+/**
+ * Result of a decoration: the printed tree and the messages as sorted lines,
+ * the incremental decorator groups the messages by declaration thus their order differs.
+ */
+struct Decoration {
+    bool ok;
+    string tree;
+    vector<string> messages;
+};
+
+vector<string> sortedLines(const string &text) {
+  vector<string> lines;
+  stringstream stream(text);
+  string line;
+  while (getline(stream, line)) {
+    if (!line.empty()) {
+      lines.push_back(line);
+    }
+  }
+  sort(lines.begin(), lines.end());
+  return lines;
+}
+
+
+/**
+ * Program entry point
+ * Applies random edits to a program and checks after each update of the IncrementalDecorator
+ * that the tree, the messages and the links are the same as decorating the whole program again.
+ */
+int main() {
+  const int steps = 2000;
+  CorpusConfig config;
+  config.functions = 8;
+  config.classes = 4;
+  config.statementDepth = 1;
+  string source = CorpusGenerator(config).generate();
+  TestSource testSource("incremental-decorator-test");
+  testSource.use(source);
+  IncrementalParser parser(source);
+  IncrementalDecorator decorator(parser);
+
+  // each substitution is applied in both directions, thus the program changes back and forth
+  vector<pair<string, string>> substitutions = {
+      {"result = result + ", "result = result * "},
+      {"(a: i32, b: i32 = 2): i32", "(a: i32, b: i32 = 3): i32"},
+      {"(a: i32, b: i32 = 2): i32", "(a: i32, b: i32 = 2, d: i32 = 4): i32"},
+      {"(a: i32, b: i32 = 2): i32", "(a: i32): i32"},
+      {"x: i32 = ", "x: f32 = "},
+      {"  y: i32 = ", "  z: i32 = "},
+      {"fun fun3(", "fun fun3x("},
+      {"class Point1 ", "class Point1x "},
+      {"let globalCounter: i32", "let globalCounter: bool"},
+      {"let result = 0;", "let result = globalCounter;"},
+      {"fun sum(factor: i32): i32", "fun sum(factor: i32): f32"},
+      {"fun sum(factor: i32)", "fun sum(factor: i32, offset: i32 = 1)"},
+      {"  fun sum(", "  fun sub("},
+      {"+ point.sum(b)", "+ point.x"},
+      {"point.x = a;", "point.z = a;"},
+      {"  return result;\n}", "  return result > 1;\n}"},
+  };
+  mt19937 random(1);
+  size_t decorated = 0, declarations = 0, failedUpdates = 0;
+  // edits to undo the applied substitutions, undone while the program has errors to also cover programs without errors
+  vector<TextEdit> undoEdits;
+  bool lastOk = true;
+  for (int step = 0; step <= steps; step++) {
+    if (step > 0 && !lastOk && !undoEdits.empty() && random() % 2) {
+      parser.applyEdit(undoEdits.back());
+      undoEdits.pop_back();
+    }
+    else if (step > 0) {
+      const string &text = parser.getText();
+      auto &substitution = substitutions[random() % substitutions.size()];
+      bool backwards = random() % 2;
+      const string &from = backwards ? substitution.second : substitution.first;
+      const string &to = backwards ? substitution.first : substitution.second;
+      vector<size_t> occurrences;
+      for (size_t pos = from.empty() ? string::npos : text.find(from); pos != string::npos; pos = text.find(from, pos + 1)) {
+        occurrences.push_back(pos);
+      }
+      if (occurrences.empty()) {
+        step--;
+        continue;
+      }
+      size_t pos = occurrences[random() % occurrences.size()];
+      undoEdits.push_back({(uint32_t) pos, (uint32_t) to.size(), from});
+      parser.applyEdit({(uint32_t) pos, (uint32_t) from.size(), to});
+    }
+
+    string text = parser.getText();
+    testSource.use(text);
+    Decoration expected;
+    {
+      RootDeclarations root = Parser(Lexer(text).getAllTokens()).parse();
+      stringstream messages;
+      {
+        MessagesRedirect redirect(messages);
+        expected.ok = AstDecorator().linkNames(root);
+      }
+      expected.messages = sortedLines(messages.str());
+      expected.tree = printTree(root);
+
+      stringstream actualMessages;
+      bool ok;
+      {
+        MessagesRedirect redirect(actualMessages);
+        ok = decorator.update();
+      }
+      RootDeclarations &actualRoot = parser.getRoot();
+      string differentLink = compareLinks(root, actualRoot);
+      bool sameTree = printTree(actualRoot) == expected.tree;
+      bool sameMessages = sortedLines(actualMessages.str()) == expected.messages;
+      if (ok != expected.ok || !sameTree || !sameMessages || !differentLink.empty()) {
+        cout << "ERR: step " << step << " differs from decorating the whole program:"
+             << (ok != expected.ok ? " result" : "") << (sameTree ? "" : " tree") << (sameMessages ? "" : " messages")
+             << (differentLink.empty() ? "" : " link to " + differentLink) << endl;
+        cout << "-- program:" << endl << text << endl;
+        return 1;
+      }
+      lastOk = ok;
+      failedUpdates += !ok;
+      if (step > 0) {
+        decorated += decorator.getDecoratedCount();
+        declarations += actualRoot.classDeclarations.size() + actualRoot.functionDeclarations.size() + actualRoot.variableDeclarations.size();
+      }
+    }
+  }
+
+  if (decorated >= declarations || failedUpdates == 0 || failedUpdates > steps) {
+    cout << "ERR: edits did not cover partial updates and programs with and without errors" << endl;
+    return 1;
+  }
+  cout << steps << " edits passed (" << failedUpdates << " with errors), decorated "
+       << decorated << " of " << declarations << " declarations" << endl;
+  return 0;
+}
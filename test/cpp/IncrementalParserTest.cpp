@@ -0,0 +1,175 @@
+#include <random>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <experimental/filesystem>
+#include <termcolor/termcolor.hpp>
+#include <ir/builder/exceptions.h>
+#include "Log.h"
+#include "lexer/Lexer.h"
+#include "parser/Parser.h"
+#include "parser/IncrementalParser.h"
+#include "SourceManager.h"
+#include "AstVisitor/AstPrinter.h"
+#include "parser/AST_addFunc.h"
+#include "CorpusGenerator.h"
+#include "TestHelper.h"
+
+using namespace std;
+namespace fs = std::experimental::filesystem;
+
+
+TestSource testSource("incremental-parser-test");
+
+/**
+ * The printed tree with the locations of all nodes in the text.
+ */
+string printTree(RootDeclarations &root, const string &text) {
+  testSource.use(text);
+  return printTree(root);
+}
+
+/**
+ * Result of parsing the whole text with Parser::parse().
+ */
+struct FullParse {
+    bool ok;
+    string tree;
+};
+
+FullParse parseFull(const string &text) {
+  try {
+    RootDeclarations root = Parser(Lexer(text).getAllTokens()).parse();
+    return {true, printTree(root, text)};
+  }
+  catch (exception &e) {
+    return {false, ""};
+  }
+}
+
+/**
+ * Apply the edit to the incremental parser and compare its ast with the ast of parsing the whole text again.
+ * @return true if the edited text could be parsed
+ */
+bool applyAndCompare(IncrementalParser &parser, const TextEdit &edit, const string &what) {
+  string expectedText = parser.getText();
+  expectedText.replace(edit.offset, edit.removedLength, edit.insertedText);
+  FullParse expected = parseFull(expectedText);
+
+  bool ok = true;
+  try {
+    parser.applyEdit(edit);
+  }
+  catch (exception &e) {
+    ok = false;
+  }
+
+  check(parser.getText() == expectedText, what + ": text differs");
+  if (ok != expected.ok) {
+    check(false, what + ": incremental parsing " + (ok ? "succeeded" : "failed") + " but parsing the whole text " + (expected.ok ? "succeeded" : "failed"));
+  }
+  else if (ok) {
+    check(printTree(parser.getRoot(), parser.getText()) == expected.tree, what + ": ast differs from parsing the whole text");
+  }
+  return ok;
+}
+
+/**
+ * Undo the edit, thus the text stays parseable.
+ */
+TextEdit undoEdit(const TextEdit &edit, const string &textBeforeEdit) {
+  return TextEdit{edit.offset, (uint32_t) edit.insertedText.size(), textBeforeEdit.substr(edit.offset, edit.removedLength)};
+}
+
+
+/**
+ * Program entry point
+ * Applies random edits to a generated program and checks after each edit that the ast of the IncrementalParser
+ * is the same as parsing the whole text again, including edits that open comments or strings
+ * and enough edits to let the arena grow past the limit of the incremental parser.
+ */
+int main() {
+  CorpusConfig config;
+  config.functions = 12;
+  config.classes = 3;
+  config.statementDepth = 1;
+  string source = CorpusGenerator(config).generate()
+                  + "\nlet greeting: str = \"hello\";\n"
+                  + "fun greet(name: str) {\n  let text: str = \"hello \";\n}\n"
+                  + "fun first() {\n}\nfun second() {\n}\n/* comment */\nfun third() {\n}\n";
+  IncrementalParser parser(source);
+  check(printTree(parser.getRoot(), parser.getText()) == parseFull(source).tree, "initial ast differs from parsing the whole text");
+
+  // a comment opened before the function first ends after the function second,
+  // thus the tokens after the edited declaration change and the whole text is parsed again
+  {
+    string text = parser.getText();
+    size_t open = text.find("fun first()");
+    check(open != string::npos, "no function first found");
+    if (open != string::npos) {
+      size_t fullParses = parser.getFullParsesCount();
+      TextEdit edit{(uint32_t) open, 0, "/*"};
+      check(applyAndCompare(parser, edit, "edit opening a comment"), "edit opening a comment was not parsed");
+      check(parser.getFullParsesCount() == fullParses + 1, "edit opening a comment did not parse the whole text");
+      applyAndCompare(parser, undoEdit(edit, text), "edit removing the comment start");
+    }
+  }
+
+  // an unterminated string fails, the next edit parses the whole text again
+  {
+    string text = parser.getText();
+    size_t stringStart = text.find("\"hello \"");
+    check(stringStart != string::npos, "no string found");
+    if (stringStart != string::npos) {
+      TextEdit edit{(uint32_t) stringStart + 7, 1, ""};
+      check(!applyAndCompare(parser, edit, "edit opening a string"), "edit opening a string was parsed");
+      size_t fullParses = parser.getFullParsesCount();
+      applyAndCompare(parser, undoEdit(edit, text), "edit closing the string");
+      check(parser.getFullParsesCount() == fullParses + 1, "edit after a failed edit did not parse the whole text");
+    }
+  }
+
+  // random edits, snippets that open or close comments and strings change the tokens after the edited declaration
+  vector<string> snippets = {
+      " ", "\n", "x", "1", "+", ";", "{", "}", "(",
+      "// line comment\n", "/* comment */", "/*", "*/", "//", "\"", "\"text\"",
+      "let q: i32 = 3;\n", "fun added(): i32 {\n  return 1;\n}\n", "class Added {\n  v: i32 = 0;\n}\n"
+  };
+  mt19937 random(1);
+  const int edits = 2000;
+  size_t parsedEdits = 0, failedEdits = 0;
+  for (int i = 0; i < edits; i++) {
+    string text = parser.getText();
+    TextEdit edit;
+    edit.offset = random() % (text.size() + 1);
+    edit.removedLength = random() % 3 == 0 ? min<size_t>(random() % 8, text.size() - edit.offset) : 0;
+    edit.insertedText = random() % 4 == 0 ? "" : snippets[random() % snippets.size()];
+
+    if (applyAndCompare(parser, edit, "random edit " + to_string(i))) {
+      parsedEdits++;
+    }
+    else {
+      // afterwards the whole text is parsed again
+      failedEdits++;
+      applyAndCompare(parser, undoEdit(edit, text), "undo of random edit " + to_string(i));
+    }
+  }
+  check(parsedEdits > 0 && failedEdits > 0, "random edits did not cover valid and invalid edits");
+
+  // edits within a function body only reparse that function, the replaced nodes stay in the arena until it grows
+  // past its limit and the whole text is parsed again
+  {
+    size_t body = parser.getText().find("  return result;\n}");
+    check(body != string::npos, "no function body found");
+    size_t fullParses = parser.getFullParsesCount();
+    const int bodyEdits = body != string::npos ? 500 : 0;
+    for (int i = 0; i < bodyEdits; i++) {
+      TextEdit edit = i % 2 == 0 ? TextEdit{(uint32_t) body, 0, " "} : TextEdit{(uint32_t) body, 1, ""};
+      applyAndCompare(parser, edit, "body edit " + to_string(i));
+    }
+    check(parser.getFullParsesCount() > fullParses, "arena growth did not parse the whole text again");
+  }
+
+  return testResult(to_string(edits) + " random edits (" + to_string(failedEdits) + " invalid) and arena growth passed, "
+                    + to_string(parser.getFullParsesCount()) + " times the whole text was parsed");
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+#include <unordered_map>
+#include <experimental/filesystem>
+#include "SourceManager.h"
+#include "parser/AST.h"
+#include "parser/Types.h"
+#include "AstVisitor/AstPrinter.h"
+
+using namespace std;
+namespace fs = std::experimental::filesystem;
+
+
+/// ********************************************************************
+/// helpers shared by the tests in test/cpp
+
+/** amount of failed checks of the test */
+inline int testFailures = 0;
+
+/**
+ * Print the failure and go on with the test, thus all failures are reported.
+ */
+inline void check(bool ok, const string &what) {
+  if (!ok) {
+    cout << "ERR: " << what << endl;
+    testFailures++;
+  }
+}
+
+/**
+ * @return exit code of the test, prints the summary when all checks passed
+ */
+inline int testResult(const string &summary) {
+  if (testFailures > 0) {
+    cout << testFailures << " checks failed" << endl;
+    return 1;
+  }
+  cout << summary << endl;
+  return 0;
+}
+
+/**
+ * Temporary source file of a test, messages contain the canonical path of the source thus the file has to exist.
+ * The file is removed when the test source is destroyed.
+ */
+class TestSource {
+  public:
+    explicit TestSource(const string &name)
+        : path(fs::temp_directory_path() / ("malinc-" + name + "-" + to_string(getpid()) + ".ma")) {
+      ofstream file(path);
+    }
+    ~TestSource() {
+      fs::remove(path);
+    }
+
+    TestSource(const TestSource &) = delete;
+    TestSource &operator=(const TestSource &) = delete;
+
+    /**
+     * Set the source of the source manager, the text has to outlive its use.
+     */
+    void use(const string &text) {
+      sourceManager.setSource(path, text);
+    }
+
+  private:
+    fs::path path;
+};
+
+/**
+ * The printed tree with the locations of all nodes, locations are resolved with the current source.
+ */
+inline string printTree(RootDeclarations &root) {
+  stringstream out;
+  AstPrinter(out, true).printTree(root);
+  return out.str();
+}
+
+inline void collectPreOrder(ASTNode *node, vector<ASTNode*> &nodes) {
+  nodes.push_back(node);
+  for (auto child : node->getChildNodes()) {
+    collectPreOrder(child, nodes);
+  }
+}
+
+inline ClassDeclaration *classOfType(LangType *type) {
+  while (auto reference = dyn_cast_or_null<ReferenceType>(type)) {
+    type = reference->innerType;
+  }
+  auto classType = dyn_cast_or_null<ClassType>(type);
+  return classType ? classType->classDeclaration : nullptr;
+}
+
+/**
+ * Pre-order index of each node of an ast, variable declarations are also found by their AbstractVariableDeclaration address.
+ */
+class NodeIndices {
+  public:
+    vector<ASTNode*> nodes;
+
+    explicit NodeIndices(RootDeclarations &root) {
+      collectPreOrder(&root, nodes);
+      for (size_t i = 0; i < nodes.size(); i++) {
+        indices[nodes[i]] = i;
+        if (auto var = AbstractVariableDeclaration::fromNode(nodes[i])) {
+          indices[var] = i;
+        }
+      }
+    }
+
+    /**
+     * @return index of the linked node, -1 for null, -2 when the node is not part of the ast
+     */
+    int64_t of(const void *link) const {
+      if (!link) {
+        return -1;
+      }
+      auto found = indices.find(link);
+      return found != indices.end() ? found->second : -2;
+    }
+
+  private:
+    unordered_map<const void*, size_t> indices;
+};
+
+/**
+ * Compare the declarations all links of two decorated asts point to, the printed tree does not contain links.
+ * @return description of the first different link, empty if all links are the same
+ */
+inline string compareLinks(RootDeclarations &expectedRoot, RootDeclarations &actualRoot) {
+  NodeIndices expected(expectedRoot), actual(actualRoot);
+  if (expected.nodes.size() != actual.nodes.size()) {
+    return "amount of nodes";
+  }
+  if (expected.of(expectedRoot.mainFunction) != actual.of(actualRoot.mainFunction)) {
+    return "main function";
+  }
+
+  for (size_t i = 0; i < expected.nodes.size(); i++) {
+    ASTNode *expectedNode = expected.nodes[i], *actualNode = actual.nodes[i];
+    auto differs = [&](const void *expectedLink, const void *actualLink) {
+      return expected.of(expectedLink) != actual.of(actualLink);
+    };
+    string where = " of " + expectedNode->nodeName() + " " + to_string(i);
+
+    if (auto ex = dyn_cast<Expression>(expectedNode)) {
+      if (differs(classOfType(ex->resultType), classOfType(cast<Expression>(actualNode)->resultType))) {
+        return "result type" + where;
+      }
+    }
+    if (auto var = AbstractVariableDeclaration::fromNode(expectedNode)) {
+      if (differs(classOfType(var->type), classOfType(AbstractVariableDeclaration::fromNode(actualNode)->type))) {
+        return "variable type" + where;
+      }
+    }
+    if (auto func = dyn_cast<FunctionDeclaration>(expectedNode)) {
+      if (differs(classOfType(func->returnType), classOfType(cast<FunctionDeclaration>(actualNode)->returnType))) {
+        return "return type" + where;
+      }
+    }
+    if (auto call = dyn_cast<CallExpression>(expectedNode)) {
+      if (differs(call->functionDeclaration, cast<CallExpression>(actualNode)->functionDeclaration)) {
+        return "called function" + where;
+      }
+    }
+    if (auto arg = dyn_cast<CallExpressionArgument>(expectedNode)) {
+      if (differs(arg->argumentDeclaration, cast<CallExpressionArgument>(actualNode)->argumentDeclaration)) {
+        return "argument declaration" + where;
+      }
+    }
+    if (auto var = dyn_cast<VariableExpression>(expectedNode)) {
+      if (differs(var->variableDeclaration, cast<VariableExpression>(actualNode)->variableDeclaration)) {
+        return "variable" + where;
+      }
+    }
+  }
+  return "";
+}